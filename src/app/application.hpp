@@ -9,6 +9,7 @@
 #include "render/graphicsContext.hpp"
 #include "ui/gui.hpp"
 #include "ui/settingsPanel.hpp"
+#include "ui/streamingPanel.hpp"
 #include "ui/tileInspectorPanel.hpp"
 #include "ui/worldEditPanel.hpp"
 #include "util/logger.hpp"
@@ -22,7 +23,7 @@ using AppComponentPack = AppComponentsMixin<Settings, Logger, Window, GameGraphi
 
 class Application: public AppComponentPack {
 public:
-   Application(): AppComponentPack(static_cast<Settings&>(*this)) {}
+   Application(): AppComponentPack(static_cast<Settings&>(*this)) { game.initAppComponent(getComponent<Settings>()); }
 
    Application(Application& other) = delete;
    Application(Application&& other) = delete;
@@ -105,6 +106,8 @@ private:
       }
       editPanel.draw(game.getTileRegistry(), reinterpret_cast<ImTextureID>(game.getAtlasView()), game.getEditStatus());
       tileInspectorPanel.draw(game.getTileRegistry(), reinterpret_cast<ImTextureID>(game.getAtlasView()), game.getTileInspection());
+      streamingPanel.draw(getComponent<Settings>().accessSection<StreamingSettings>(), getComponent<Settings>().accessSection<WorkerSettings>(), game.getActiveWorkers(),
+                          game.getWorkerCount(), game.getStreamingStats());
 
       const wgpu::RenderPassEncoder pass = ctx.beginRenderPass({0.0, 0.0, 0.0, 1.0});
       getComponent<GameGraphics>().draw(pass, game.getDrawData());
@@ -149,6 +152,10 @@ private:
          tileInspectorPanel.toggle();
          return;
       }
+      if (e.pressed && e.key == Key::F4) {
+         streamingPanel.toggle();
+         return;
+      }
       if (ui.consumeKeyboard()) {
          return;
       }
@@ -161,6 +168,7 @@ private:
    SettingsPanel settingsPanel;
    WorldEditPanel editPanel;
    TileInspectorPanel tileInspectorPanel;
+   StreamingPanel streamingPanel;
 
    Input input;
    Game game;
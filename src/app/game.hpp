@@ -1,14 +1,23 @@
 #pragma once
 
 #include "app/input/input.hpp"
+#include "app/settings/settings.hpp"
+#include "app/workerGovernor.hpp"
+#include "app/workerSettings.hpp"
 #include "app/worldView.hpp"
 #include "core/graphics/gameGraphics.hpp"
 #include "core/graphics/renderSettings.hpp"
 #include "core/resources/resource.hpp"
 #include "core/world/contents/atlasCell.hpp"
+#include "core/world/contents/defaultEntities.hpp"
+#include "core/world/contents/defaultTiles.hpp"
 #include "core/world/contents/entity.hpp"
 #include "core/world/ecs/components.hpp"
+#include "core/world/generation/generatorSettings.hpp"
+#include "core/world/generation/noisePresets.hpp"
 #include "core/world/planet.hpp"
+#include "core/world/streamingSettings.hpp"
+#include "core/world/streamingStats.hpp"
 #include "core/world/worldArea.hpp"
 #include "core/worldInteraction/tileInspection.hpp"
 #include "core/worldInteraction/worldEdit.hpp"
@@ -16,6 +25,7 @@
 #include "util/logger.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <entt/entt.hpp>
 #include <memory>
 #include <optional>
@@ -26,13 +36,23 @@
 
 class Game {
 public:
-   Game(): threadPool(std::clamp(std::thread::hardware_concurrency() - 1, 1u, 4u)) {}
+   // one worker per hardware thread besides the main one, the governor decides how many of them run
+   Game(): threadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1) {}
 
    ~Game() {
       threadPool.shutdown();
       planets.clear();
    }
 
+   void initAppComponent(Settings& settings) {
+      settings.addSection<StreamingSettings>();
+      streamingSettings = &settings.accessSection<StreamingSettings>();
+      settings.addSection<WorkerSettings>();
+      workerSettings = &settings.accessSection<WorkerSettings>();
+      settings.addSection<GeneratorSettings>();
+      generatorSettings = &settings.accessSection<GeneratorSettings>();
+   }
+
    [[nodiscard]] bool initialize(GameGraphics* graphics, GpuContext& gpuContext, wgpu::Queue gpuQueue) {
       graphicsCtx = graphics;
       queue = gpuQueue;
@@ -50,6 +70,15 @@ public:
          return false;
       }
 
+      // built once for all planets; a planet naming a preset the file lacks gets temperate
+      const std::optional<FastSIMD::eLevel> simdLevel = NoisePresets::parseSimdLevel(generatorSettings->noiseSimd);
+      if (!simdLevel) {
+         Logger::warn("unknown noise simd level '{}', using auto", generatorSettings->noiseSimd);
+      }
+      noisePresets.emplace(simdLevel.value_or(FastSIMD::Level_Null));
+      noisePresets->load(generatorSettings->presetsPath);
+      Logger::info("noise presets run on {}", NoisePresets::simdLevelName(noisePresets->activeSimdLevel()));
+
       const PlanetContext planetContext{.device = device,
                                         .queue = queue,
                                         .terrainLayout = graphicsCtx->getBindGroupLayout(),
@@ -58,12 +87,17 @@ public:
                                         .atlas = atlasTexture,
                                         .entitySheet = entityTexture,
                                         .tileRegistry = tileRegistry,
-                                        .entityRegistry = entityRegistry};
+                                        .entityRegistry = entityRegistry,
+                                        .noisePresets = *noisePresets,
+                                        .worldDirectory = streamingSettings->worldDirectory};
 
       const PlanetConfig configs[] = {
          {.position = {-1200.0f, 0.0f}, .seed = 42, .baseSize = 512.0f, .idleScrollSpeed = {60.0f, 30.0f}, .orbitParams = {1000.0f, 0.2f}},
          {.position = {0.0f, 0.0f}, .seed = 1337, .baseSize = 1024.0f, .idleScrollSpeed = {-17.0f, 0.0f}},
          {.position = {1200.0f, 0.0f}, .seed = 2550, .baseSize = 300.0f, .orbitParams = {1500.0f, -0.4f}},
+         // the planets above predate presets and keep their terrain, these two show the shipped ones
+         {.position = {-2200.0f, 0.0f}, .seed = 7, .baseSize = 400.0f, .idleScrollSpeed = {0.0f, 25.0f}, .orbitParams = {2200.0f, 0.1f}, .preset = "frozen"},
+         {.position = {2200.0f, 0.0f}, .seed = 8128, .baseSize = 400.0f, .idleScrollSpeed = {-25.0f, 0.0f}, .orbitParams = {2200.0f, 0.1f}, .preset = "arid"},
       };
       for (const PlanetConfig& config : configs) {
          planets.push_back(std::make_unique<Planet>(config, planetContext));
@@ -74,6 +108,7 @@ public:
    }
 
    void update(float dtSeconds, const Input& input, glm::ivec2 windowSize, const RenderSettings& settings, const WorldEditBrush& brush) {
+      const auto updateStart = std::chrono::steady_clock::now();
       worldView.handleInput(input, planets, windowSize, brush.active);
 
       const int focusedIndex = worldView.getFocusedPlanetIndex();
@@ -81,9 +116,15 @@ public:
       if (focusedIndex >= 0) {
          cursorWorld = planets[static_cast<size_t>(focusedIndex)]->pickWorld(input.getMousePosition(), worldView.getCamera(), windowSize);
       }
+      const int planetCount = std::max<int>(static_cast<int>(planets.size()), 1);
+      const StreamingBudget streamingBudget{.integration = std::chrono::microseconds{std::max(streamingSettings->integrationBudgetUs, 0) / planetCount},
+                                            .chunkCacheBytes = static_cast<size_t>(std::max(streamingSettings->chunkCacheMB, 0)) * 1024 * 1024 / static_cast<size_t>(planetCount),
+                                            .prefetchSeconds = streamingSettings->prefetchSeconds};
       for (size_t i = 0; i < planets.size(); ++i) {
          const bool focused = std::cmp_equal(i, focusedIndex);
-         planets[i]->update(dtSeconds, focused, focused ? worldView.getPlanetControlAxis() : glm::vec2(0.0f), focused ? cursorWorld : std::nullopt);
+         StreamingBudget planetBudget = streamingBudget;
+         planetBudget.lod = planets[i]->generationLod(worldView.getCamera().getScale(), streamingSettings->fullDetailPixelsPerTile);
+         planets[i]->update(dtSeconds, focused, focused ? worldView.getPlanetControlAxis() : glm::vec2(0.0f), focused ? cursorWorld : std::nullopt, planetBudget);
       }
 
       worldView.update(dtSeconds, planets);
@@ -95,6 +136,9 @@ public:
          planets[i]->preRender(worldView.getCamera(), windowSize, depth, settings);
       }
       collectDrawData();
+      collectStreamingStats();
+      const std::chrono::duration<float> work = std::chrono::steady_clock::now() - updateStart;
+      workerGovernor.update(threadPool, *workerSettings, dtSeconds, work.count(), streamingBacklog());
 
       tileInspection = inspectUnderCursor(input.getMousePosition(), windowSize);
    }
@@ -104,6 +148,9 @@ public:
    [[nodiscard]] WGPUTextureView getAtlasView() const { return atlasTexture.getRawView(); }
    [[nodiscard]] const EditStatus& getEditStatus() const { return editStatus; }
    [[nodiscard]] const std::optional<TileInspection>& getTileInspection() const { return tileInspection; }
+   [[nodiscard]] const std::vector<StreamingStats>& getStreamingStats() const { return streamingStats; }
+   [[nodiscard]] size_t getActiveWorkers() const { return threadPool.activeWorkers(); }
+   [[nodiscard]] size_t getWorkerCount() const { return threadPool.size(); }
 
 private:
    [[nodiscard]] std::optional<TileInspection> inspectUnderCursor(const glm::vec2 screenPos, const glm::ivec2 windowSize) const {
@@ -154,6 +201,21 @@ private:
       }
    }
 
+   void collectStreamingStats() {
+      streamingStats.clear();
+      for (const auto& planet : planets) {
+         streamingStats.push_back(planet->area().getStreamingStats());
+      }
+   }
+
+   [[nodiscard]] size_t streamingBacklog() const {
+      size_t backlog = 0;
+      for (const StreamingStats& stats : streamingStats) {
+         backlog += stats.queuedJobs + stats.inFlightJobs;
+      }
+      return backlog;
+   }
+
    void seedDebugActors(Planet& planet) {
       const EntityDefinition& def = entityRegistry.get(EntityKind::Player);
       entt::registry& registry = planet.area().entities().registry();
@@ -176,25 +238,8 @@ private:
    }
 
    void initializeGameContent() {
-      tileRegistry.add(TileID::Grass, {.atlasBase = {0, 0}, .variationCount = 4, .name = "Grass"});
-      tileRegistry.add(TileID::Water, {.atlasBase = {1, 0}, .variationCount = 4, .name = "Water"});
-      tileRegistry.add(TileID::ColdGrass, {.atlasBase = {2, 0}, .variationCount = 4, .name = "Cold Grass"});
-      tileRegistry.add(TileID::Stone, {.atlasBase = {3, 0}, .variationCount = 4, .softness = 0.4f, .name = "Stone"});
-      tileRegistry.add(TileID::HardStone, {.atlasBase = {4, 0}, .variationCount = 4, .softness = 0.4f, .name = "Hard Stone"});
-      tileRegistry.add(TileID::Sand, {.atlasBase = {5, 0}, .variationCount = 4, .name = "Sand"});
-      tileRegistry.add(TileID::ColdWater, {.atlasBase = {6, 0}, .variationCount = 4, .name = "Cold Water"});
-      tileRegistry.add(TileID::Ice, {.atlasBase = {7, 0}, .variationCount = 4, .name = "Ice"});
-      tileRegistry.add(TileID::Snow, {.atlasBase = {8, 0}, .variationCount = 4, .name = "Snow"});
-      tileRegistry.add(TileID::RedOre, {.atlasBase = {9, 0}, .variationCount = 1, .name = "Red Ore"});
-      tileRegistry.add(TileID::BlueOre, {.atlasBase = {10, 0}, .variationCount = 1, .name = "Blue Ore"});
-      tileRegistry.add(TileID::BurntGround, {.atlasBase = {11, 0}, .variationCount = 1, .name = "Burnt Ground"});
-      tileRegistry.add(TileID::Gravel, {.atlasBase = {12, 0}, .variationCount = 1, .softness = 0.7f, .name = "Gravel"});
-      tileRegistry.add(TileID::HardGravel, {.atlasBase = {13, 0}, .variationCount = 1, .name = "Hard Gravel"});
-      tileRegistry.add(TileID::Planks, {.atlasBase = {14, 0}, .variationCount = 1, .softness = 0.0f, .name = "Planks"});
-      tileRegistry.add(TileID::PlankFloor, {.atlasBase = {15, 0}, .variationCount = 1, .name = "Plank Floor"});
-
-      entityRegistry.add(EntityKind::Player, {.spriteCell = {0, 0}, .dimensions = {1.0f, 1.0f}, .name = "Player"});
-      entityRegistry.add(EntityKind::Tree, {.spriteCell = {0, 3}, .dimensions = {1.0f, 1.0f}, .name = "Tree"});
+      registerDefaultTiles(tileRegistry);
+      registerDefaultEntities(entityRegistry);
    }
 
    ResourceManager resourceManager;
@@ -203,14 +248,20 @@ private:
 
    std::vector<std::unique_ptr<Planet>> planets;
    std::vector<PlanetDrawData> drawData;
+   std::vector<StreamingStats> streamingStats;
 
    GameGraphics* graphicsCtx = nullptr;
+   StreamingSettings* streamingSettings = nullptr;
+   WorkerSettings* workerSettings = nullptr;
+   GeneratorSettings* generatorSettings = nullptr;
    wgpu::Queue queue = nullptr;
 
    Threadpool threadPool;
+   WorkerGovernor workerGovernor;
 
    TileRegistry tileRegistry;
    EntityRegistry entityRegistry;
+   std::optional<NoisePresets> noisePresets;
    WorldView worldView;
    EditStatus editStatus;
    std::optional<TileInspection> tileInspection;
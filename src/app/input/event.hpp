@@ -14,6 +14,7 @@ enum class Key : uint8_t {
    F1,
    F2,
    F3,
+   F4,
    Count
 };
 
@@ -0,0 +1,52 @@
+#pragma once
+#include "app/workerSettings.hpp"
+#include "util/threadpool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+// grows the active worker set while chunk jobs pile up and shrinks it when streaming goes idle or the main thread
+// runs over its work budget. decisions are made a few times per second against the smoothed time the main thread
+// spent in its update, the frame time itself is bound to vsync and says nothing about contention
+class WorkerGovernor {
+public:
+   void update(Threadpool& pool, const WorkerSettings& settings, const float dtSeconds, const float workSeconds, const size_t backlog) {
+      if (settings.pinWorkers != pinned) {
+         pool.pinWorkers(settings.pinWorkers);
+         pinned = settings.pinWorkers;
+      }
+
+      const size_t maxWorkers = settings.maxWorkers > 0 ? std::min(static_cast<size_t>(settings.maxWorkers), pool.size()) : pool.size();
+      const size_t minWorkers = std::clamp(static_cast<size_t>(std::max(settings.minWorkers, 1)), size_t{1}, maxWorkers);
+
+      smoothedWorkMs += (workSeconds * 1000.0f - smoothedWorkMs) * workSmoothing;
+      idleSeconds = backlog == 0 ? idleSeconds + dtSeconds : 0.0f;
+      sinceDecision += dtSeconds;
+
+      size_t target = std::clamp(pool.activeWorkers(), minWorkers, maxWorkers);
+      if (sinceDecision >= decisionInterval) {
+         sinceDecision = 0.0f;
+         const bool overBudget = smoothedWorkMs > settings.workBudgetMs;
+         if (backlog > target * backlogPerWorker && !overBudget) {
+            // grow fast, a teleport wants every core right now
+            target = std::min(target + std::max<size_t>(target / 2, 1), maxWorkers);
+         } else if (overBudget && target > minWorkers) {
+            --target;
+         } else if (idleSeconds >= idleShrinkSeconds && target > minWorkers) {
+            --target;
+         }
+      }
+      pool.setActiveWorkers(target);
+   }
+
+private:
+   static constexpr float decisionInterval = 0.25f;
+   static constexpr float idleShrinkSeconds = 1.0f;
+   static constexpr float workSmoothing = 0.1f;
+   static constexpr size_t backlogPerWorker = 8;
+
+   float smoothedWorkMs = 0.0f;
+   float idleSeconds = 0.0f;
+   float sinceDecision = 0.0f;
+   bool pinned = false;
+};
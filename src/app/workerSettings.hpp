@@ -0,0 +1,20 @@
+#pragma once
+
+struct WorkerSettings {
+   int minWorkers = 1;
+   int maxWorkers = 0;   // 0 = one per hardware thread, minus the main thread
+   bool pinWorkers = false;
+
+   // main thread work per frame above this makes the governor give cores back to it
+   float workBudgetMs = 10.0f;
+
+   static constexpr const char* key = "workers";
+
+   template<typename Self, typename Fn>
+   static void forEachField(Self& self, Fn&& fn) {
+      fn("minWorkers", self.minWorkers);
+      fn("maxWorkers", self.maxWorkers);
+      fn("pinWorkers", self.pinWorkers);
+      fn("workBudgetMs", self.workBudgetMs);
+   }
+};
@@ -2,11 +2,16 @@
 
 #include "core/world/contents/entity.hpp"
 #include "core/world/contents/tile.hpp"
+#include "core/world/tileStorage.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <span>
 #include <vector>
 
 class Chunk {
+   friend class ChunkCodec;
    friend class ChunkMesher;
 
 public:
@@ -14,25 +19,88 @@ public:
    static constexpr int SIZE_SQUARED = SIZE * SIZE;
    static constexpr int COUNT = 32;
    static constexpr int COUNT_SQUARED = COUNT * COUNT;
+   // tiles are stored with a one-tile apron copied from the eight neighbours
+   static constexpr int PADDED_SIZE = SIZE + 2;
 
-   explicit Chunk(const glm::ivec2 pos): pos(pos) {
-      terrainMap.resize(SIZE_SQUARED, TileID::Water);
-      heightMap.resize(SIZE_SQUARED, 0.0f);
+   // x and y in [-1, SIZE], the outermost ring is the apron
+   static constexpr size_t tileIndex(const int x, const int y) { return static_cast<size_t>((y + 1) * PADDED_SIZE + x + 1); }
+
+   Chunk() { reset({}); }
+
+   explicit Chunk(const glm::ivec2 pos) { reset(pos); }
+
+   // back to a blank chunk at pos; entity capacity is kept for pooled reuse
+   void reset(const glm::ivec2 newPos) {
+      tiles.fill(TileID::Water, 0.0f);
+      entities.clear();
+      pos = newPos;
+      apronLinks = 0;
+      liveApronLinks = 0;
+      meshed = false;
+      lod = 0;
    }
 
    void setTerrain(const int x, const int y, const TileID id, const float height) {
       if (x < 0 || x >= SIZE || y < 0 || y >= SIZE) {
          return;
       }
-      const int idx = y * SIZE + x;
-      terrainMap[idx] = id;
-      heightMap[idx] = height;
+      tiles.set(tileIndex(x, y), id, height);
+   }
+
+   // a whole interior row at once, for the generator
+   void setTerrainRow(const int y, const std::span<const TileID, SIZE> ids, const std::span<const float, SIZE> heights) {
+      const size_t first = tileIndex(0, y);
+      for (size_t x = 0; x < SIZE; ++x) {
+         tiles.set(first + x, ids[x], heights[x]);
+      }
    }
 
+   // copies the edge of neighbor that faces this chunk into the apron. direction points from here to neighbor
+   void copyApron(const Chunk& neighbor, const glm::ivec2 direction) {
+      copyApronTiles(neighbor, direction);
+      apronLinks |= apronBit(direction);
+      liveApronLinks |= apronBit(direction);
+   }
+
+   // the neighbour in direction unloaded. its copy stays for meshing, but no longer counts as its terrain
+   void unlinkApron(const glm::ivec2 direction) { liveApronLinks &= static_cast<uint16_t>(~apronBit(direction)); }
+
+   // copyApron without recording the link, so threads may fill different sides of one chunk at once
+   void copyApronTiles(const Chunk& neighbor, const glm::ivec2 direction) {
+      const auto range = [](const int d) { return d < 0 ? glm::ivec2{-1, 0} : d > 0 ? glm::ivec2{SIZE, SIZE + 1} : glm::ivec2{0, SIZE}; };
+      const glm::ivec2 xs = range(direction.x);
+      const glm::ivec2 ys = range(direction.y);
+      for (int y = ys.x; y < ys.y; ++y) {
+         for (int x = xs.x; x < xs.y; ++x) {
+            const size_t src = tileIndex(x - direction.x * SIZE, y - direction.y * SIZE);
+            tiles.setRaw(tileIndex(x, y), neighbor.tiles.id(src), neighbor.tiles.rawHeight(src));
+         }
+      }
+   }
+
+   // the interior tiles, position and level of other. the apron and entities are left alone
+   void copyInterior(const Chunk& other) {
+      for (int y = 0; y < SIZE; ++y) {
+         for (int x = 0; x < SIZE; ++x) {
+            const size_t i = tileIndex(x, y);
+            tiles.setRaw(i, other.tiles.id(i), other.tiles.rawHeight(i));
+         }
+      }
+      pos = other.pos;
+      lod = other.lod;
+   }
+
+   // every neighbour has been copied in at least once. the copy of one that unloaded since is kept
+   [[nodiscard]] bool isApronComplete() const { return apronLinks == allApronLinks; }
+
+   // the neighbour in direction is loaded and copied in
+   [[nodiscard]] bool hasApron(const glm::ivec2 direction) const { return (liveApronLinks & apronBit(direction)) != 0; }
+
    void addEntity(const EntitySpawn& entity) { entities.push_back(entity); }
 
-   [[nodiscard]] TileID terrainAt(const int x, const int y) const { return terrainMap[y * SIZE + x]; }
-   [[nodiscard]] float heightAt(const int x, const int y) const { return heightMap[y * SIZE + x]; }
+   // x and y in [-1, SIZE], apron included
+   [[nodiscard]] TileID terrainAt(const int x, const int y) const { return tiles.id(tileIndex(x, y)); }
+   [[nodiscard]] float heightAt(const int x, const int y) const { return tiles.height(tileIndex(x, y)); }
 
    [[nodiscard]] const std::vector<EntitySpawn>& getEntities() const { return entities; }
 
@@ -42,13 +110,25 @@ public:
 
    void markMeshed() { meshed = true; }
 
+   // 0 for full detail, otherwise the generator sampled one tile per 2^lod x 2^lod cell and repeated it
+   [[nodiscard]] uint8_t getLod() const { return lod; }
+
+   void setLod(const uint8_t level) { lod = level; }
+
 private:
-   std::vector<TileID> terrainMap;
-   std::vector<float> heightMap;
+   static constexpr uint16_t apronBit(const glm::ivec2 direction) { return static_cast<uint16_t>(1u << ((direction.y + 1) * 3 + direction.x + 1)); }
+
+   // all nine bits but the center
+   static constexpr uint16_t allApronLinks = 0x1FF & ~(1u << 4);
+
+   TileStorage<PADDED_SIZE * PADDED_SIZE> tiles;
    std::vector<EntitySpawn> entities;
 
    glm::ivec2 pos{};
+   uint16_t apronLinks = 0;
+   uint16_t liveApronLinks = 0;   // apronLinks minus neighbours that unloaded since
    bool meshed = false;
+   uint8_t lod = 0;
 };
 
 inline glm::ivec2 toChunkCoord(const glm::ivec2 worldTile) {
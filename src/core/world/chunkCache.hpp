@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/world/chunk.hpp"
+#include "core/world/chunkCodec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/gtx/hash.hpp>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// recently unloaded chunks kept compressed, so panning back decodes them instead of running the generator again.
+// least recently stored goes first once the byte budget is exceeded. main thread only
+class ChunkCache {
+public:
+   void setBudget(const size_t bytes) {
+      budget = bytes;
+      evictOverBudget();
+   }
+
+   // coarse chunks are left out, they are cheap to generate again and must not come back as full detail
+   void store(const Chunk& chunk) {
+      if (budget == 0 || chunk.getLod() != 0) {
+         return;
+      }
+      ChunkCodec::encode(chunk, scratch);
+      put(chunk.getPos(), std::vector<uint8_t>(scratch.begin(), scratch.end()));
+   }
+
+   // hands an unused blob back, e.g. when the load that took it was cancelled
+   void put(const glm::ivec2 pos, std::vector<uint8_t> blob) {
+      erase(pos);
+      bytes += blob.size();
+      order.push_front({pos, std::move(blob)});
+      index.emplace(pos, order.begin());
+      evictOverBudget();
+   }
+
+   // the blob leaves the cache, a restored chunk is stored again when it unloads
+   [[nodiscard]] std::optional<std::vector<uint8_t>> take(const glm::ivec2 pos) {
+      const auto it = index.find(pos);
+      if (it == index.end()) {
+         ++misses;
+         return std::nullopt;
+      }
+      ++hits;
+      std::vector<uint8_t> blob = std::move(it->second->blob);
+      bytes -= blob.size();
+      order.erase(it->second);
+      index.erase(it);
+      return blob;
+   }
+
+   [[nodiscard]] bool contains(const glm::ivec2 pos) const { return index.contains(pos); }
+   [[nodiscard]] bool enabled() const { return budget != 0; }
+
+   [[nodiscard]] uint64_t hitCount() const { return hits; }
+   [[nodiscard]] uint64_t missCount() const { return misses; }
+   [[nodiscard]] size_t size() const { return index.size(); }
+   [[nodiscard]] size_t sizeBytes() const { return bytes; }
+
+private:
+   struct Entry {
+      glm::ivec2 pos;
+      std::vector<uint8_t> blob;
+   };
+
+   void erase(const glm::ivec2 pos) {
+      const auto it = index.find(pos);
+      if (it == index.end()) {
+         return;
+      }
+      bytes -= it->second->blob.size();
+      order.erase(it->second);
+      index.erase(it);
+   }
+
+   void evictOverBudget() {
+      while (bytes > budget && !order.empty()) {
+         bytes -= order.back().blob.size();
+         index.erase(order.back().pos);
+         order.pop_back();
+      }
+   }
+
+   std::list<Entry> order;   // most recent first
+   std::unordered_map<glm::ivec2, std::list<Entry>::iterator> index;
+   std::vector<uint8_t> scratch;
+   size_t budget = 0;
+   size_t bytes = 0;
+   uint64_t hits = 0;
+   uint64_t misses = 0;
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "core/world/chunk.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <vector>
+
+// display and packed map of a chunk as ChunkMesher writes them
+struct BakedMaps {
+   std::array<uint8_t, Chunk::SIZE_SQUARED> display{};
+   std::array<uint16_t, Chunk::SIZE_SQUARED> packed{};
+};
+
+// lossless chunk compression: tile ids as (id, run) pairs, heights as zigzag deltas of the stored raw value,
+// all varint coded. generated terrain is smooth and patchy, so a chunk typically shrinks to a few hundred bytes.
+// offline baked blobs append the chunk's maps uncompressed. edited chunks are written without them
+class ChunkCodec {
+public:
+   static void encode(const Chunk& chunk, std::vector<uint8_t>& out, const BakedMaps* maps = nullptr) {
+      out.clear();
+
+      writeVarint(out, chunk.entities.size());
+      for (const EntitySpawn& entity : chunk.entities) {
+         out.push_back(static_cast<uint8_t>(entity.kind));
+         for (const float v : {entity.position.x, entity.position.y, entity.position.z}) {
+            writeVarint(out, std::bit_cast<uint32_t>(v));
+         }
+      }
+
+      for (size_t i = 0; i < Chunk::SIZE_SQUARED;) {
+         const TileID id = chunk.tiles.id(interior(i));
+         size_t run = 1;
+         while (i + run < Chunk::SIZE_SQUARED && chunk.tiles.id(interior(i + run)) == id) {
+            ++run;
+         }
+         out.push_back(static_cast<uint8_t>(id));
+         writeVarint(out, run);
+         i += run;
+      }
+
+      // flat stretches (water, edited plateaus) collapse to a zero followed by the number of further zeros
+      int64_t previous = 0;
+      for (size_t i = 0; i < Chunk::SIZE_SQUARED;) {
+         const auto raw = static_cast<int64_t>(chunk.tiles.rawHeight(interior(i)));
+         writeVarint(out, zigzag(raw - previous));
+         ++i;
+         if (raw == previous) {
+            size_t repeats = 0;
+            while (i < Chunk::SIZE_SQUARED && chunk.tiles.rawHeight(interior(i)) == static_cast<RawHeight>(raw)) {
+               ++repeats;
+               ++i;
+            }
+            writeVarint(out, repeats);
+         }
+         previous = raw;
+      }
+
+      if (maps) {
+         out.push_back(bakedMapsTag);
+         out.insert(out.end(), maps->display.begin(), maps->display.end());
+         for (const uint16_t v : maps->packed) {
+            out.push_back(static_cast<uint8_t>(v));
+            out.push_back(static_cast<uint8_t>(v >> 8));
+         }
+      }
+   }
+
+   // chunk keeps its position, everything else comes from the blob. false on a truncated or corrupt blob, which
+   // includes tile and entity ids the registries do not know. maps holds the baked ones afterwards, or nothing
+   // when the blob has none
+   static bool decode(const std::span<const uint8_t> in, Chunk& chunk, const TileRegistry& tiles, const EntityRegistry& entities,
+                      std::optional<BakedMaps>* maps = nullptr) {
+      if (maps) {
+         maps->reset();
+      }
+      Reader reader{in};
+      chunk.reset(chunk.pos);
+
+      const uint64_t entityCount = reader.varint();
+      for (uint64_t e = 0; e < entityCount && reader.ok; ++e) {
+         EntitySpawn entity{.kind = static_cast<EntityKind>(reader.byte())};
+         if (!entities.contains(entity.kind)) {
+            return false;
+         }
+         for (float* v : {&entity.position.x, &entity.position.y, &entity.position.z}) {
+            *v = std::bit_cast<float>(static_cast<uint32_t>(reader.varint()));
+         }
+         chunk.entities.push_back(entity);
+      }
+
+      std::array<TileID, Chunk::SIZE_SQUARED> ids{};
+      for (size_t i = 0; i < Chunk::SIZE_SQUARED && reader.ok;) {
+         const auto id = static_cast<TileID>(reader.byte());
+         const uint64_t run = reader.varint();
+         if (run == 0 || run > Chunk::SIZE_SQUARED - i || !tiles.contains(id)) {
+            return false;
+         }
+         std::fill_n(ids.begin() + static_cast<std::ptrdiff_t>(i), run, id);
+         i += run;
+      }
+
+      int64_t previous = 0;
+      for (size_t i = 0; i < Chunk::SIZE_SQUARED && reader.ok;) {
+         const int64_t delta = unzigzag(reader.varint());
+         previous += delta;
+         chunk.tiles.setRaw(interior(i), ids[i], static_cast<RawHeight>(previous));
+         ++i;
+         if (delta == 0) {
+            const uint64_t repeats = reader.varint();
+            if (repeats > Chunk::SIZE_SQUARED - i) {
+               return false;
+            }
+            for (const size_t end = i + repeats; i < end; ++i) {
+               chunk.tiles.setRaw(interior(i), ids[i], static_cast<RawHeight>(previous));
+            }
+         }
+      }
+
+      if (reader.ok && reader.at < in.size()) {
+         if (reader.byte() != bakedMapsTag || in.size() - reader.at != bakedMapsBytes) {
+            return false;
+         }
+         if (maps) {
+            const std::span<const uint8_t> bytes = in.subspan(reader.at);
+            BakedMaps& baked = maps->emplace();
+            std::ranges::copy(bytes.first(Chunk::SIZE_SQUARED), baked.display.begin());
+            for (size_t i = 0; i < Chunk::SIZE_SQUARED; ++i) {
+               baked.packed[i] = static_cast<uint16_t>(bytes[Chunk::SIZE_SQUARED + 2 * i] | bytes[Chunk::SIZE_SQUARED + 2 * i + 1] << 8);
+            }
+         }
+         reader.at = in.size();
+      }
+      return reader.ok && reader.at == in.size();
+   }
+
+private:
+   using RawHeight = decltype(Chunk::tiles)::RawHeight;
+
+   static constexpr uint8_t bakedMapsTag = 0xB1;
+   static constexpr size_t bakedMapsBytes = Chunk::SIZE_SQUARED * (sizeof(uint8_t) + sizeof(uint16_t));
+
+   // blobs hold the tiles in row order without the apron, the apron is relinked when the chunk is integrated
+   static constexpr size_t interior(const size_t i) { return Chunk::tileIndex(static_cast<int>(i % Chunk::SIZE), static_cast<int>(i / Chunk::SIZE)); }
+
+   struct Reader {
+      std::span<const uint8_t> in;
+      size_t at = 0;
+      bool ok = true;
+
+      uint8_t byte() {
+         if (at >= in.size()) {
+            ok = false;
+            return 0;
+         }
+         return in[at++];
+      }
+
+      uint64_t varint() {
+         uint64_t value = 0;
+         for (int shift = 0; shift < 64 && ok; shift += 7) {
+            const uint8_t b = byte();
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+               return value;
+            }
+         }
+         ok = false;
+         return 0;
+      }
+   };
+
+   static void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+      while (value >= 0x80) {
+         out.push_back(static_cast<uint8_t>(value | 0x80));
+         value >>= 7;
+      }
+      out.push_back(static_cast<uint8_t>(value));
+   }
+
+   static uint64_t zigzag(const int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+   static int64_t unzigzag(const uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/world/chunk.hpp"
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <memory>
+#include <utility>
+
+// loaded chunks on a torus, the same wrap the render buffers use: a position owns slot (pos & (SIZE - 1)) and the
+// slot keeps the position as a tag, so a lookup is a mask and one compare. the loaded window must fit into SIZE
+class ChunkGrid {
+public:
+   static constexpr int SIZE = Chunk::COUNT;
+
+   [[nodiscard]] Chunk* find(const glm::ivec2 pos) {
+      const Slot& slot = slots[indexOf(pos)];
+      return slot.chunk && slot.pos == pos ? slot.chunk.get() : nullptr;
+   }
+
+   [[nodiscard]] const Chunk* find(const glm::ivec2 pos) const {
+      const Slot& slot = slots[indexOf(pos)];
+      return slot.chunk && slot.pos == pos ? slot.chunk.get() : nullptr;
+   }
+
+   // null when pos is not loaded, a chunk from the other side of the torus does not count
+   [[nodiscard]] std::shared_ptr<Chunk> findShared(const glm::ivec2 pos) const {
+      const Slot& slot = slots[indexOf(pos)];
+      return slot.chunk && slot.pos == pos ? slot.chunk : nullptr;
+   }
+
+   [[nodiscard]] bool contains(const glm::ivec2 pos) const { return find(pos) != nullptr; }
+
+   // returns whatever chunk held the slot before, from this position or the other side of the torus
+   std::shared_ptr<Chunk> insert(std::shared_ptr<Chunk> chunk) {
+      Slot& slot = slots[indexOf(chunk->getPos())];
+      count += slot.chunk ? 0 : 1;
+      slot.pos = chunk->getPos();
+      return std::exchange(slot.chunk, std::move(chunk));
+   }
+
+   template<typename Fn>
+   void forEach(Fn&& fn) const {
+      for (const Slot& slot : slots) {
+         if (slot.chunk) {
+            fn(*slot.chunk);
+         }
+      }
+   }
+
+   // pred(const Chunk&), returns how many chunks were dropped
+   template<typename Pred>
+   size_t eraseIf(Pred&& pred) {
+      size_t erased = 0;
+      for (Slot& slot : slots) {
+         if (slot.chunk && pred(*slot.chunk)) {
+            slot.chunk.reset();
+            ++erased;
+         }
+      }
+      count -= erased;
+      return erased;
+   }
+
+   [[nodiscard]] size_t size() const { return count; }
+
+private:
+   struct Slot {
+      glm::ivec2 pos{};
+      std::shared_ptr<Chunk> chunk;
+   };
+
+   static constexpr int mask = SIZE - 1;
+   static_assert((SIZE & mask) == 0, "the torus is indexed with a mask");
+
+   static size_t indexOf(const glm::ivec2 pos) { return static_cast<size_t>((pos.y & mask) * SIZE + (pos.x & mask)); }
+
+   std::array<Slot, static_cast<size_t>(SIZE * SIZE)> slots{};
+   size_t count = 0;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <optional>
+#include <vector>
+
+// chunk generation jobs waiting for a worker, ordered by distance to the camera chunk moved ahead by the camera's lead.
+// visible chunks (inside the projected disk, or in the ring its meshes need) always go before the rest of the loading square
+class ChunkJobQueue {
+public:
+   void push(const glm::ivec2 pos) {
+      entries.push_back(makeEntry(pos));
+      sorted = false;
+   }
+
+   [[nodiscard]] std::optional<glm::ivec2> pop() {
+      if (entries.empty()) {
+         return std::nullopt;
+      }
+      if (!sorted) {
+         // best job at the back
+         std::ranges::sort(entries, [](const Entry& a, const Entry& b) { return b.before(a); });
+         sorted = true;
+      }
+      const glm::ivec2 pos = entries.back().pos;
+      entries.pop_back();
+      return pos;
+   }
+
+   void reprioritize(const glm::ivec2 newCenter, const int32_t newVisibleRadius, const glm::ivec2 newLead = {}) {
+      center = newCenter;
+      visibleRadius = newVisibleRadius;
+      lead = newLead;
+      for (Entry& entry : entries) {
+         entry = makeEntry(entry.pos);
+      }
+      sorted = false;
+   }
+
+   template<typename Pred>
+   void eraseIf(Pred&& pred) {
+      std::erase_if(entries, [&](const Entry& entry) { return pred(entry.pos); });
+   }
+
+   [[nodiscard]] size_t size() const { return entries.size(); }
+
+private:
+   struct Entry {
+      glm::ivec2 pos{};
+      bool visible = false;
+      int32_t distanceSq = 0;
+
+      [[nodiscard]] bool before(const Entry& other) const {
+         if (visible != other.visible) {
+            return visible;
+         }
+         return distanceSq < other.distanceSq;
+      }
+   };
+
+   [[nodiscard]] Entry makeEntry(const glm::ivec2 pos) const {
+      const glm::ivec2 d = pos - center;
+      const glm::ivec2 ahead = d - lead;
+      const int32_t meshedRadius = visibleRadius + 1;
+      return {.pos = pos, .visible = d.x * d.x + d.y * d.y <= meshedRadius * meshedRadius, .distanceSq = ahead.x * ahead.x + ahead.y * ahead.y};
+   }
+
+   std::vector<Entry> entries;
+   glm::ivec2 center{};
+   glm::ivec2 lead{};
+   int32_t visibleRadius = 0;
+   bool sorted = true;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "core/world/chunk.hpp"
+#include "util/slotArena.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+
+// recycles chunks together with their shared_ptr control blocks. a chunk goes back to the pool when its last
+// reference drops, on whichever thread that happens, and keeps its entity capacity for the next position.
+// the pool must outlive every chunk it handed out
+class ChunkPool {
+public:
+   // any thread
+   [[nodiscard]] std::shared_ptr<Chunk> acquire(const glm::ivec2 pos) {
+      Chunk* chunk = chunks.acquire();
+      chunk->reset(pos);
+
+      const uint32_t nowLive = live.fetch_add(1, std::memory_order_relaxed) + 1;
+      uint32_t seen = highWater.load(std::memory_order_relaxed);
+      while (nowLive > seen && !highWater.compare_exchange_weak(seen, nowLive, std::memory_order_relaxed)) {}
+
+      return {chunk, Recycle{this}, ControlBlockAllocator<Chunk>{this}};
+   }
+
+   [[nodiscard]] uint32_t liveChunks() const { return live.load(std::memory_order_relaxed); }
+   [[nodiscard]] uint32_t highWaterChunks() const { return highWater.load(std::memory_order_relaxed); }
+   [[nodiscard]] uint32_t capacity() const { return chunks.capacity(); }
+
+private:
+   struct Recycle {
+      ChunkPool* pool;
+
+      void operator ()(Chunk* chunk) const {
+         pool->live.fetch_sub(1, std::memory_order_relaxed);
+         pool->chunks.release(chunk);
+      }
+   };
+
+   // room for the control block of a shared_ptr with a deleter and allocator, checked where it is instantiated
+   struct alignas(16) ControlBlock {
+      std::array<std::byte, 64> storage;
+   };
+
+   template<typename T>
+   struct ControlBlockAllocator {
+      using value_type = T;
+
+      explicit ControlBlockAllocator(ChunkPool* pool): pool(pool) {}
+
+      template<typename U>
+      explicit(false) ControlBlockAllocator(const ControlBlockAllocator<U>& other): pool(other.pool) {}
+
+      T* allocate(const size_t n) {
+         static_assert(sizeof(T) <= sizeof(ControlBlock) && alignof(T) <= alignof(ControlBlock));
+         assert(n == 1);
+         return reinterpret_cast<T*>(pool->controlBlocks.acquire());
+      }
+
+      void deallocate(T* block, const size_t /*n*/) { pool->controlBlocks.release(reinterpret_cast<ControlBlock*>(block)); }
+
+      template<typename U>
+      bool operator ==(const ControlBlockAllocator<U>& other) const {
+         return pool == other.pool;
+      }
+
+      ChunkPool* pool;
+   };
+
+   SlotArena<Chunk> chunks;
+   SlotArena<ControlBlock> controlBlocks;
+   std::atomic<uint32_t> live{0};
+   std::atomic<uint32_t> highWater{0};
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "core/world/contents/entity.hpp"
+
+// the entity kinds of the game, shared with the offline tools so they accept the chunks the game writes
+inline void registerDefaultEntities(EntityRegistry& entityRegistry) {
+   entityRegistry.add(EntityKind::Player, {.spriteCell = {0, 0}, .dimensions = {1.0f, 1.0f}, .name = "Player"});
+   entityRegistry.add(EntityKind::Tree, {.spriteCell = {0, 3}, .dimensions = {1.0f, 1.0f}, .name = "Tree"});
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core/world/contents/tile.hpp"
+
+// the tile set of the game, shared with the offline tools so baked regions match streamed ones
+inline void registerDefaultTiles(TileRegistry& tileRegistry) {
+   tileRegistry.add(TileID::Grass, {.atlasBase = {0, 0}, .variationCount = 4, .name = "Grass"});
+   tileRegistry.add(TileID::Water, {.atlasBase = {1, 0}, .variationCount = 4, .name = "Water"});
+   tileRegistry.add(TileID::ColdGrass, {.atlasBase = {2, 0}, .variationCount = 4, .name = "Cold Grass"});
+   tileRegistry.add(TileID::Stone, {.atlasBase = {3, 0}, .variationCount = 4, .softness = 0.4f, .name = "Stone"});
+   tileRegistry.add(TileID::HardStone, {.atlasBase = {4, 0}, .variationCount = 4, .softness = 0.4f, .name = "Hard Stone"});
+   tileRegistry.add(TileID::Sand, {.atlasBase = {5, 0}, .variationCount = 4, .name = "Sand"});
+   tileRegistry.add(TileID::ColdWater, {.atlasBase = {6, 0}, .variationCount = 4, .name = "Cold Water"});
+   tileRegistry.add(TileID::Ice, {.atlasBase = {7, 0}, .variationCount = 4, .name = "Ice"});
+   tileRegistry.add(TileID::Snow, {.atlasBase = {8, 0}, .variationCount = 4, .name = "Snow"});
+   tileRegistry.add(TileID::RedOre, {.atlasBase = {9, 0}, .variationCount = 1, .name = "Red Ore"});
+   tileRegistry.add(TileID::BlueOre, {.atlasBase = {10, 0}, .variationCount = 1, .name = "Blue Ore"});
+   tileRegistry.add(TileID::BurntGround, {.atlasBase = {11, 0}, .variationCount = 1, .name = "Burnt Ground"});
+   tileRegistry.add(TileID::Gravel, {.atlasBase = {12, 0}, .variationCount = 1, .softness = 0.7f, .name = "Gravel"});
+   tileRegistry.add(TileID::HardGravel, {.atlasBase = {13, 0}, .variationCount = 1, .name = "Hard Gravel"});
+   tileRegistry.add(TileID::Planks, {.atlasBase = {14, 0}, .variationCount = 1, .softness = 0.0f, .name = "Planks"});
+   tileRegistry.add(TileID::PlankFloor, {.atlasBase = {15, 0}, .variationCount = 1, .name = "Plank Floor"});
+}
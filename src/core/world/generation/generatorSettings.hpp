@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+// read once at startup, the noise graphs are built before the first planet and not rebuilt
+struct GeneratorSettings {
+   // presets planets can name besides the built-in temperate one, see NoisePresets::load
+   std::string presetsPath = "assets/worldgen/presets.yaml";
+   // highest instruction set noise runs on: auto, scalar, sse2, sse41, avx2, avx512 or neon. lower than what the cpu
+   // has only for comparing levels, a level the cpu lacks falls back to the best it has
+   std::string noiseSimd = "auto";
+
+   static constexpr const char* key = "generator";
+
+   template<typename Self, typename Fn>
+   static void forEachField(Self& self, Fn&& fn) {
+      fn("presetsPath", self.presetsPath);
+      fn("noiseSimd", self.noiseSimd);
+   }
+};
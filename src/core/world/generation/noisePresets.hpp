@@ -0,0 +1,346 @@
+#pragma once
+
+#include "util/logger.hpp"
+
+#include <FastNoise/FastNoise.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+// one noise layer of a preset: a source, optionally summed into a fractal, optionally domain warped and shifted by
+// offset, sampled at frequency per tile
+struct NoiseLayerDesc {
+   enum class Source : uint8_t { Simplex, Perlin, Value, CellularValue, White };
+   enum class Fractal : uint8_t { None, Ridged, FBm };
+
+   Source source = Source::Simplex;
+   Fractal fractal = Fractal::None;
+   int octaves = 3;
+   float gain = 0.5f;
+   float lacunarity = 2.0f;
+   float jitter = 1.0f;          // cellular sources only
+   float warpAmplitude = 0.0f;   // 0 leaves the layer unwarped
+   float warpFrequency = 0.005f;
+   float offset = 0.0f;   // added to every sample, moves the layer against the fixed biome thresholds
+   float frequency = 0.01f;
+
+   template<typename Self, typename Fn>
+   static void forEachField(Self& self, Fn&& fn) {
+      fn("source", self.source);
+      fn("fractal", self.fractal);
+      fn("octaves", self.octaves);
+      fn("gain", self.gain);
+      fn("lacunarity", self.lacunarity);
+      fn("jitter", self.jitter);
+      fn("warpAmplitude", self.warpAmplitude);
+      fn("warpFrequency", self.warpFrequency);
+      fn("offset", self.offset);
+      fn("frequency", self.frequency);
+   }
+};
+
+// the layers WorldGenerator samples
+struct NoisePreset {
+   NoiseLayerDesc elevation;
+   NoiseLayerDesc river;
+   NoiseLayerDesc temperature;
+   NoiseLayerDesc moisture;
+   NoiseLayerDesc ore;
+   NoiseLayerDesc trees;
+};
+
+struct NoiseLayer {
+   FastNoise::SmartNode<> node;
+   float frequency = 0.0f;
+};
+
+// a preset built into FastNoise node trees. never changed once built, so all generators of a preset and all their
+// workers share one graph; generation only calls the nodes' const Gen functions
+struct NoiseGraph {
+   std::string name;
+   NoiseLayer elevation;
+   NoiseLayer river;
+   NoiseLayer temperature;
+   NoiseLayer moisture;
+   NoiseLayer ore;
+   NoiseLayer trees;
+};
+
+namespace YAML {
+   template<>
+   struct convert<NoiseLayerDesc::Source> {
+      static Node encode(const NoiseLayerDesc::Source& source) { return Node(std::string(names[static_cast<size_t>(source)])); }
+
+      static bool decode(const Node& node, NoiseLayerDesc::Source& source) {
+         const auto it = node.IsScalar() ? std::ranges::find(names, std::string_view(node.Scalar())) : names.end();
+         if (it == names.end()) {
+            return false;
+         }
+         source = static_cast<NoiseLayerDesc::Source>(it - names.begin());
+         return true;
+      }
+
+   private:
+      static constexpr std::array<std::string_view, 5> names{"simplex", "perlin", "value", "cellularValue", "white"};
+   };
+
+   template<>
+   struct convert<NoiseLayerDesc::Fractal> {
+      static Node encode(const NoiseLayerDesc::Fractal& fractal) { return Node(std::string(names[static_cast<size_t>(fractal)])); }
+
+      static bool decode(const Node& node, NoiseLayerDesc::Fractal& fractal) {
+         const auto it = node.IsScalar() ? std::ranges::find(names, std::string_view(node.Scalar())) : names.end();
+         if (it == names.end()) {
+            return false;
+         }
+         fractal = static_cast<NoiseLayerDesc::Fractal>(it - names.begin());
+         return true;
+      }
+
+   private:
+      static constexpr std::array<std::string_view, 3> names{"none", "ridged", "fbm"};
+   };
+}   // namespace YAML
+
+// named noise presets, the built-in one and those loaded from yaml, each built into its NoiseGraph once when added.
+// graphs run on the simd level given at construction, or the best the cpu has for FastSIMD::Level_Null; FastNoise
+// falls back to a lower level the cpu does support
+class NoisePresets {
+public:
+   // the terrain of planets from before presets. built in and not redefinable, saved and baked worlds depend on it
+   static constexpr std::string_view defaultPreset = "temperate";
+
+   explicit NoisePresets(const FastSIMD::eLevel simdLevel = FastSIMD::Level_Null): simdLevel(simdLevel) {
+      graphs.emplace(defaultPreset, build(std::string(defaultPreset), temperate(), simdLevel));
+   }
+
+   // adds the presets of a file of the form
+   //
+   //    presets:
+   //      arid:
+   //        temperature: {offset: 0.4}
+   //        moisture: {fractal: ridged, offset: -0.4}
+   //
+   // layers and fields a preset leaves out are the default preset's. false when the file cannot be read or a preset
+   // in it is malformed; the well-formed ones are added either way
+   bool load(const std::filesystem::path& path) {
+      YAML::Node root;
+      try {
+         root = YAML::LoadFile(path.string());
+      } catch (const std::exception& e) {
+         Logger::warn("noise presets: could not load '{}' ({})", path.string(), e.what());
+         return false;
+      }
+
+      const YAML::Node presets = root["presets"];
+      if (!presets.IsMap()) {
+         Logger::warn("noise presets: '{}' has no presets map", path.string());
+         return false;
+      }
+
+      bool ok = true;
+      for (const auto& entry : presets) {
+         const std::string name = entry.first.Scalar();
+         if (name == defaultPreset) {
+            Logger::warn("noise presets: '{}' is built in and cannot be redefined by '{}'", name, path.string());
+            ok = false;
+            continue;
+         }
+         NoisePreset preset = temperate();
+         if (!parsePreset(entry.second, name, preset)) {
+            ok = false;
+            continue;
+         }
+         graphs.insert_or_assign(name, build(name, preset, simdLevel));
+      }
+      return ok;
+   }
+
+   // null for an unknown name
+   [[nodiscard]] std::shared_ptr<const NoiseGraph> find(const std::string_view name) const {
+      const auto it = graphs.find(name);
+      return it == graphs.end() ? nullptr : it->second;
+   }
+
+   // the default preset with a warning for an unknown name
+   [[nodiscard]] std::shared_ptr<const NoiseGraph> get(const std::string_view name) const {
+      if (std::shared_ptr<const NoiseGraph> graph = find(name)) {
+         return graph;
+      }
+      Logger::warn("noise presets: no preset '{}', using '{}'", name, defaultPreset);
+      return graphs.find(defaultPreset)->second;
+   }
+
+   [[nodiscard]] std::vector<std::string> names() const {
+      std::vector<std::string> out;
+      for (const auto& [name, graph] : graphs) {
+         out.push_back(name);
+      }
+      return out;
+   }
+
+   // the level the graphs run on, after FastNoise matched the requested one to the cpu
+   [[nodiscard]] FastSIMD::eLevel activeSimdLevel() const { return graphs.find(defaultPreset)->second->elevation.node->GetSIMDLevel(); }
+
+   // the default preset on the best level the cpu has, built on first use. for generators made without presets
+   static const std::shared_ptr<const NoiseGraph>& builtin() {
+      static const std::shared_ptr<const NoiseGraph> graph = build(std::string(defaultPreset), temperate(), FastSIMD::Level_Null);
+      return graph;
+   }
+
+   // "auto" is FastSIMD::Level_Null
+   [[nodiscard]] static std::optional<FastSIMD::eLevel> parseSimdLevel(const std::string_view name) {
+      const auto it = std::ranges::find(simdLevelNames, name, &std::pair<FastSIMD::eLevel, std::string_view>::second);
+      return it == simdLevelNames.end() ? std::nullopt : std::optional(it->first);
+   }
+
+   [[nodiscard]] static std::string_view simdLevelName(const FastSIMD::eLevel level) {
+      const auto it = std::ranges::find(simdLevelNames, level, &std::pair<FastSIMD::eLevel, std::string_view>::first);
+      return it == simdLevelNames.end() ? "unknown" : it->second;
+   }
+
+   static NoisePreset temperate() {
+      using Fractal = NoiseLayerDesc::Fractal;
+      using Source = NoiseLayerDesc::Source;
+      return {.elevation = {.fractal = Fractal::Ridged, .octaves = 5, .warpAmplitude = 40.0f, .warpFrequency = 0.005f, .frequency = 0.004f},
+              .river = {.fractal = Fractal::Ridged, .octaves = 3, .warpAmplitude = 20.0f, .warpFrequency = 0.005f, .frequency = 0.005f},
+              .temperature = {.warpAmplitude = 10.0f, .warpFrequency = 0.01f, .frequency = 0.002f},
+              .moisture = {.fractal = Fractal::FBm, .warpAmplitude = 30.0f, .warpFrequency = 0.005f, .frequency = 0.003f},
+              .ore = {.source = Source::CellularValue, .jitter = 1.2f, .frequency = 0.05f},
+              .trees = {.source = Source::White, .frequency = 1.0f}};
+   }
+
+private:
+   static constexpr std::array<std::pair<std::string_view, NoiseLayerDesc NoisePreset::*>, 6> layerNames{{{"elevation", &NoisePreset::elevation},
+                                                                                                          {"river", &NoisePreset::river},
+                                                                                                          {"temperature", &NoisePreset::temperature},
+                                                                                                          {"moisture", &NoisePreset::moisture},
+                                                                                                          {"ore", &NoisePreset::ore},
+                                                                                                          {"trees", &NoisePreset::trees}}};
+
+   static constexpr std::array<std::pair<FastSIMD::eLevel, std::string_view>, 7> simdLevelNames{{{FastSIMD::Level_Null, "auto"},
+                                                                                                  {FastSIMD::Level_Scalar, "scalar"},
+                                                                                                  {FastSIMD::Level_SSE2, "sse2"},
+                                                                                                  {FastSIMD::Level_SSE41, "sse41"},
+                                                                                                  {FastSIMD::Level_AVX2, "avx2"},
+                                                                                                  {FastSIMD::Level_AVX512, "avx512"},
+                                                                                                  {FastSIMD::Level_NEON, "neon"}}};
+
+   // stricter than settings: unknown fields and values that do not convert are errors, a preset that quietly fell
+   // back to defaults would change the terrain
+   static bool parsePreset(const YAML::Node& node, const std::string_view name, NoisePreset& preset) {
+      if (!node.IsMap()) {
+         Logger::warn("noise presets: preset '{}' is not a map of layers", name);
+         return false;
+      }
+      for (const auto& entry : node) {
+         const std::string_view layerName = entry.first.Scalar();
+         const auto layer = std::ranges::find(layerNames, layerName, &std::pair<std::string_view, NoiseLayerDesc NoisePreset::*>::first);
+         if (layer == layerNames.end() || !entry.second.IsMap()) {
+            Logger::warn("noise presets: preset '{}' has no layer '{}' or it is not a map", name, layerName);
+            return false;
+         }
+         NoiseLayerDesc& desc = preset.*(layer->second);
+         size_t fields = 0;
+         try {
+            NoiseLayerDesc::forEachField(desc, [&](const char* key, auto& ref) {
+               if (const YAML::Node value = entry.second[key]) {
+                  ref = value.as<std::remove_reference_t<decltype(ref)>>();
+                  ++fields;
+               }
+            });
+         } catch (const YAML::Exception& e) {
+            Logger::warn("noise presets: layer '{}' of preset '{}' is malformed ({})", layerName, name, e.what());
+            return false;
+         }
+         if (fields != entry.second.size()) {
+            Logger::warn("noise presets: layer '{}' of preset '{}' has unknown fields", layerName, name);
+            return false;
+         }
+         if (desc.octaves < 1 || desc.frequency <= 0.0f) {
+            Logger::warn("noise presets: layer '{}' of preset '{}' needs at least one octave and a positive frequency", layerName, name);
+            return false;
+         }
+      }
+      return true;
+   }
+
+   static FastNoise::SmartNode<> buildLayer(const NoiseLayerDesc& desc, const FastSIMD::eLevel level) {
+      FastNoise::SmartNode<> node;
+      switch (desc.source) {
+         case NoiseLayerDesc::Source::Simplex: node = FastNoise::New<FastNoise::Simplex>(level); break;
+         case NoiseLayerDesc::Source::Perlin: node = FastNoise::New<FastNoise::Perlin>(level); break;
+         case NoiseLayerDesc::Source::Value: node = FastNoise::New<FastNoise::Value>(level); break;
+         case NoiseLayerDesc::Source::CellularValue: {
+            auto cellular = FastNoise::New<FastNoise::CellularValue>(level);
+            cellular->SetJitterModifier(desc.jitter);
+            node = cellular;
+            break;
+         }
+         case NoiseLayerDesc::Source::White: node = FastNoise::New<FastNoise::White>(level); break;
+      }
+
+      const auto fractal = [&](auto fractalNode) {
+         fractalNode->SetSource(node);
+         fractalNode->SetOctaveCount(desc.octaves);
+         fractalNode->SetGain(desc.gain);
+         fractalNode->SetLacunarity(desc.lacunarity);
+         node = fractalNode;
+      };
+      if (desc.fractal == NoiseLayerDesc::Fractal::Ridged) {
+         fractal(FastNoise::New<FastNoise::FractalRidged>(level));
+      } else if (desc.fractal == NoiseLayerDesc::Fractal::FBm) {
+         fractal(FastNoise::New<FastNoise::FractalFBm>(level));
+      }
+
+      if (desc.warpAmplitude != 0.0f) {
+         auto warp = FastNoise::New<FastNoise::DomainWarpGradient>(level);
+         warp->SetSource(node);
+         warp->SetWarpAmplitude(desc.warpAmplitude);
+         warp->SetWarpFrequency(desc.warpFrequency);
+         node = warp;
+      }
+
+      if (desc.offset != 0.0f) {
+         auto add = FastNoise::New<FastNoise::Add>(level);
+         add->SetLHS(node);
+         add->SetRHS(desc.offset);
+         node = add;
+      }
+      return node;
+   }
+
+   static std::shared_ptr<const NoiseGraph> build(std::string name, const NoisePreset& preset, const FastSIMD::eLevel level) {
+      const auto layer = [level](const NoiseLayerDesc& desc) { return NoiseLayer{.node = buildLayer(desc, level), .frequency = desc.frequency}; };
+      return std::make_shared<const NoiseGraph>(NoiseGraph{.name = std::move(name),
+                                                           .elevation = layer(preset.elevation),
+                                                           .river = layer(preset.river),
+                                                           .temperature = layer(preset.temperature),
+                                                           .moisture = layer(preset.moisture),
+                                                           .ore = layer(preset.ore),
+                                                           .trees = layer(preset.trees)});
+   }
+
+   FastSIMD::eLevel simdLevel;
+   std::map<std::string, std::shared_ptr<const NoiseGraph>, std::less<>> graphs;
+};
+
+// region files hold one planet's terrain, which the seed and the preset decide. the default preset keeps the name
+// planets had before presets, so existing worlds stay where they are
+inline std::string planetDirectoryName(const uint64_t seed, const std::string_view preset) {
+   return preset == NoisePresets::defaultPreset ? std::format("planet-{}", seed) : std::format("planet-{}-{}", seed, preset);
+}
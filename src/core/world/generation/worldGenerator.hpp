@@ -2,77 +2,55 @@
 
 #include "core/world/chunk.hpp"
 #include "core/world/contents/entity.hpp"
+#include "core/world/generation/noisePresets.hpp"
 
 #include <FastNoise/FastNoise.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <format>
 #include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-class WorldGenerator {
-private:
-   struct NoiseContext {
-      FastNoise::SmartNode<> elevation;
-      FastNoise::SmartNode<> river;
-      FastNoise::SmartNode<> temperature;
-      FastNoise::SmartNode<> moisture;
-      FastNoise::SmartNode<> ore;
-      FastNoise::SmartNode<> trees;
-
-      NoiseContext() {
-         auto fnBaseElev = FastNoise::New<FastNoise::FractalRidged>();
-         fnBaseElev->SetSource(FastNoise::New<FastNoise::Simplex>());
-         fnBaseElev->SetOctaveCount(5);
-         fnBaseElev->SetGain(0.5f);
-         fnBaseElev->SetLacunarity(2.0f);
-
-         auto warpElev = FastNoise::New<FastNoise::DomainWarpGradient>();
-         warpElev->SetSource(fnBaseElev);
-         warpElev->SetWarpAmplitude(40.0f);
-         warpElev->SetWarpFrequency(0.005f);
-         elevation = warpElev;
-
-         auto fnBaseRiver = FastNoise::New<FastNoise::FractalRidged>();
-         fnBaseRiver->SetSource(FastNoise::New<FastNoise::Simplex>());
-         fnBaseRiver->SetOctaveCount(3);
-
-         auto warpRiver = FastNoise::New<FastNoise::DomainWarpGradient>();
-         warpRiver->SetSource(fnBaseRiver);
-         warpRiver->SetWarpAmplitude(20.0f);
-         warpRiver->SetWarpFrequency(0.005f);
-         river = warpRiver;
-
-         auto fnBaseTemp = FastNoise::New<FastNoise::Simplex>();
-
-         auto warpTemp = FastNoise::New<FastNoise::DomainWarpGradient>();
-         warpTemp->SetSource(fnBaseTemp);
-         warpTemp->SetWarpAmplitude(10.0f);
-         warpTemp->SetWarpFrequency(0.01f);
-         temperature = warpTemp;
-
-         auto fnBaseMoist = FastNoise::New<FastNoise::FractalFBm>();
-         fnBaseMoist->SetSource(FastNoise::New<FastNoise::Simplex>());
-
-         auto warpMoist = FastNoise::New<FastNoise::DomainWarpGradient>();
-         warpMoist->SetSource(fnBaseMoist);
-         warpMoist->SetWarpAmplitude(30.0f);
-         warpMoist->SetWarpFrequency(0.005f);
-         moisture = warpMoist;
-
-         auto fnBaseOre = FastNoise::New<FastNoise::CellularValue>();
-         fnBaseOre->SetJitterModifier(1.2f);
-         ore = fnBaseOre;
-
-         trees = FastNoise::New<FastNoise::White>();
-      }
-   };
+// tiles between two samples of a slowly varying noise layer, the tiles in between are interpolated. 1 samples every
+// tile; other values are rounded down to a power of two no larger than a chunk, so lattices line up with chunks.
+// coarser lattices change the terrain, so every tile is sampled unless a planet opts in
+struct LayerResolution {
+   int temperature = 1;
+   int moisture = 1;
+};
 
-   static const NoiseContext& getContext() {
-      static NoiseContext ctx;
-      return ctx;
+// the lattice a planet opts into for faster generation, brights_bench bounds how many tiles it changes
+inline constexpr LayerResolution coarseClimate{.temperature = 4, .moisture = 4};
+
+// a planet on a coarser lattice keeps its chunks apart from the exact planet of the same seed and preset
+inline std::string planetDirectoryName(const uint64_t seed, const std::string_view preset, const LayerResolution& resolution) {
+   const std::string name = planetDirectoryName(seed, preset);
+   if (resolution.temperature == 1 && resolution.moisture == 1) {
+      return name;
    }
+   return std::format("{}-climate{}x{}", name, resolution.temperature, resolution.moisture);
+}
 
+class WorldGenerator {
 public:
-   explicit WorldGenerator(const uint64_t seed): seed(seed) {}
+   // noise is shared with every generator of the same preset, see NoisePresets
+   explicit WorldGenerator(const uint64_t seed, const LayerResolution resolution = {}, std::shared_ptr<const NoiseGraph> noise = NoisePresets::builtin()):
+      seed(seed), resolution{.temperature = latticeStep(resolution.temperature), .moisture = latticeStep(resolution.moisture)}, noise(std::move(noise)) {}
+
+   [[nodiscard]] const LayerResolution& getResolution() const { return resolution; }
+   [[nodiscard]] const NoiseGraph& getNoise() const { return *noise; }
+
+   // samples of the ore and tree layers evaluated, and skipped because no classification reads them, since construction
+   [[nodiscard]] uint64_t evaluatedSparseSamples() const { return evaluatedSamples.load(std::memory_order_relaxed); }
+   [[nodiscard]] uint64_t skippedSparseSamples() const { return skippedSamples.load(std::memory_order_relaxed); }
 
    static float computeTerrainHeight(const float elevation, const TileID terrain) {
       bool isWater = terrain == TileID::Water || terrain == TileID::ColdWater || terrain == TileID::Ice;
@@ -100,130 +78,404 @@ public:
    }
 
    void generate(Chunk& chunk) {
-      const auto& ctx = getContext();
-
-      glm::ivec2 offset = chunk.getPos() * Chunk::SIZE;
-      int size = Chunk::SIZE;
-      int area = size * size;
-
-      thread_local std::vector<float> elevationMap(area);
-      thread_local std::vector<float> riverMap(area);
-      thread_local std::vector<float> tempMap(area);
-      thread_local std::vector<float> moistureMap(area);
-      thread_local std::vector<float> oreMap(area);
-      thread_local std::vector<float> treeMap(area);
-
-      ctx.elevation->GenUniformGrid2D(elevationMap.data(), offset.x, offset.y, size, size, 0.004f, static_cast<int>(seed));
-      ctx.river->GenUniformGrid2D(riverMap.data(), offset.x, offset.y, size, size, 0.005f, static_cast<int>(seed) + 111);
-      ctx.temperature->GenUniformGrid2D(tempMap.data(), offset.x, offset.y, size, size, 0.002f, static_cast<int>(seed) + 1923);
-      ctx.moisture->GenUniformGrid2D(moistureMap.data(), offset.x, offset.y, size, size, 0.003f, static_cast<int>(seed) + 4821);
-      ctx.ore->GenUniformGrid2D(oreMap.data(), offset.x, offset.y, size, size, 0.05f, static_cast<int>(seed) + 9991);
-      ctx.trees->GenUniformGrid2D(treeMap.data(), offset.x, offset.y, size, size, 1.0f, static_cast<int>(seed) + 555);
-
-      constexpr float treeNoiseThreshold = 0.95f;
-
-      for (int y = 0; y < size; ++y) {
-         for (int x = 0; x < size; ++x) {
-            const int idx = y * size + x;
-
-            float h = elevationMap[idx];
-            float t = tempMap[idx];
-            float m = moistureMap[idx];
-            float r = riverMap[idx];
-            float o = oreMap[idx];
-            float treeRng = treeMap[idx];
-
-            float dither = treeRng * 0.05f;
-            auto terrain = TileID::Water;
-            bool placeTree = false;
-
-            bool isRiver = (h > -0.1f && h < 0.5f) && (r > 0.85f);
-
-            if (h < -0.1f) {
-               // Ocean
-               if (t < -0.5f) {
-                  terrain = TileID::Ice;
-               } else if (t < 0.0f) {
-                  terrain = TileID::ColdWater;
-               } else {
-                  terrain = TileID::Water;
-               }
-            } else if (isRiver) {
-               // River cutting through land
-               if (t < -0.5f) {
-                  terrain = TileID::Ice;
-               } else {
-                  terrain = TileID::Water;
-               }
+      Chunk* const target = &chunk;
+      generateBlock(chunk.getPos(), {1, 1}, std::span(&target, 1));
+   }
+
+   // samples every noise layer once over a block of adjacent chunks starting at origin and scatters the result into
+   // chunks (row-major, blockSize.x * blockSize.y entries). null entries are not filled, and only the layers
+   // every tile reads are sampled for them. above lod 0 one tile per 2^lod x 2^lod cell is sampled and classified,
+   // the cell repeats it and carries at most that tile's tree; such chunks are for planets too small on screen to
+   // show single tiles
+   void generateBlock(const glm::ivec2 origin, const glm::ivec2 blockSize, const std::span<Chunk* const> chunks, const uint32_t lod = 0) {
+      const NoiseGraph& graph = *noise;
+
+      // everything below is in samples, lattice steps and frequencies scale along so sample tiles match lod 0
+      const uint32_t level = std::min(lod, maxLod);
+      const int step = 1 << level;
+      const auto scaled = [step](const float frequency) { return frequency * static_cast<float>(step); };
+      const int chunkSamples = Chunk::SIZE / step;
+      const glm::ivec2 offset = origin * chunkSamples;
+      const int width = blockSize.x * chunkSamples;
+      const int height = blockSize.y * chunkSamples;
+
+      thread_local NoiseMaps maps;
+      maps.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+
+      graph.elevation.node->GenUniformGrid2D(maps.elevation.data(), offset.x, offset.y, width, height, scaled(graph.elevation.frequency), static_cast<int>(seed));
+      graph.river.node->GenUniformGrid2D(maps.river.data(), offset.x, offset.y, width, height, scaled(graph.river.frequency), static_cast<int>(seed) + 111);
+      genLattice(*graph.temperature.node, maps.temperature, maps, offset, width, height, scaled(graph.temperature.frequency), static_cast<int>(seed) + 1923,
+                 std::max(resolution.temperature >> level, 1));
+      genLattice(*graph.moisture.node, maps.moisture, maps, offset, width, height, scaled(graph.moisture.frequency), static_cast<int>(seed) + 4821,
+                 std::max(resolution.moisture >> level, 1));
+
+      // trees and ore are only read by some tiles (see readsTreeNoise and readsOreNoise) and evaluated there alone
+      const SparseBlock block{.offset = offset, .width = width, .chunkSamples = chunkSamples, .blockSize = blockSize, .chunks = chunks};
+      genSparse(*graph.trees.node, maps.trees, maps, block, scaled(graph.trees.frequency), static_cast<int>(seed) + 555,
+                [](const size_t i) { return readsTreeNoise(maps.elevation[i], maps.river[i]); });
+      genSparse(*graph.ore.node, maps.ore, maps, block, scaled(graph.ore.frequency), static_cast<int>(seed) + 9991, [](const size_t i) { return readsOreNoise(maps.elevation[i]); });
+
+      for (int by = 0; by < blockSize.y; ++by) {
+         for (int bx = 0; bx < blockSize.x; ++bx) {
+            if (Chunk* chunk = chunks[by * blockSize.x + bx]) {
+               fillChunk(*chunk, maps, width, by * chunkSamples * width + bx * chunkSamples, level);
+            }
+         }
+      }
+   }
+
+   struct TileClass {
+      TileID id = TileID::Water;
+      float height = 0.0f;
+      bool tree = false;
+   };
+
+   // one row of noise samples, Chunk::SIZE floats behind each pointer
+   struct RowSamples {
+      const float* elevation;
+      const float* river;
+      const float* temperature;
+      const float* moisture;
+      const float* ore;
+      const float* trees;
+   };
+
+   struct ClassifiedRow {
+      std::array<TileID, Chunk::SIZE> ids{};
+      std::array<float, Chunk::SIZE> heights{};
+      std::array<uint8_t, Chunk::SIZE> trees{};
+   };
+
+   // the biome rules one tile at a time. generation runs classifyRow, this is the reference it is checked against
+   static TileClass classifyTile(const float h, const float t, const float m, const float r, const float o, const float treeRng) {
+      float dither = treeRng * 0.05f;
+      auto terrain = TileID::Water;
+      bool placeTree = false;
+
+      bool isRiver = (h > -0.1f && h < 0.5f) && (r > 0.85f);
+
+      if (h < -0.1f) {
+         // Ocean
+         if (t < -0.5f) {
+            terrain = TileID::Ice;
+         } else if (t < 0.0f) {
+            terrain = TileID::ColdWater;
+         } else {
+            terrain = TileID::Water;
+         }
+      } else if (isRiver) {
+         // River cutting through land
+         if (t < -0.5f) {
+            terrain = TileID::Ice;
+         } else {
+            terrain = TileID::Water;
+         }
+      } else {
+         // Beach
+         if (h < 0.0f) {
+            terrain = TileID::Sand;
+         } else if (h > 0.7f) {
+            // High Altitudes
+            if (h > 0.85f) {
+               terrain = TileID::HardStone;   // Peaks
             } else {
-               // Beach
-               if (h < 0.0f) {
-                  terrain = TileID::Sand;
-               } else if (h > 0.7f) {
-                  // High Altitudes
-                  if (h > 0.85f) {
-                     terrain = TileID::HardStone;   // Peaks
-                  } else {
-                     terrain = TileID::Stone;
-                  }
+               terrain = TileID::Stone;
+            }
 
-                  // Mountain Snow (with dither for ragged snow line)
-                  if ((t + dither) < -0.2f || h > 0.9f) {
-                     terrain = TileID::Snow;
-                  }
+            // Mountain Snow (with dither for ragged snow line)
+            if ((t + dither) < -0.2f || h > 0.9f) {
+               terrain = TileID::Snow;
+            }
+         } else {
+            // Standard Biomes
+            if ((t + dither) < -0.3f) {
+               // Cold
+               terrain = TileID::Snow;
+            } else if ((t + dither) > 0.4f && (m + dither) < -0.2f) {
+               // Hot & Dry (Desert)
+               terrain = TileID::Sand;
+            } else if ((t + dither) > 0.4f && (m + dither) < 0.1f) {
+               // Hot & Semi-dry (Savanna/Burnt)
+               terrain = TileID::BurntGround;
+            } else {
+               // Temperate
+               if ((m + dither) < -0.3f) {
+                  terrain = TileID::Gravel;   // Wasteland
+               } else if ((t + dither) < 0.1f) {
+                  terrain = TileID::ColdGrass;
                } else {
-                  // Standard Biomes
-                  if ((t + dither) < -0.3f) {
-                     // Cold
-                     terrain = TileID::Snow;
-                  } else if ((t + dither) > 0.4f && (m + dither) < -0.2f) {
-                     // Hot & Dry (Desert)
-                     terrain = TileID::Sand;
-                  } else if ((t + dither) > 0.4f && (m + dither) < 0.1f) {
-                     // Hot & Semi-dry (Savanna/Burnt)
-                     terrain = TileID::BurntGround;
-                  } else {
-                     // Temperate
-                     if ((m + dither) < -0.3f) {
-                        terrain = TileID::Gravel;   // Wasteland
-                     } else if ((t + dither) < 0.1f) {
-                        terrain = TileID::ColdGrass;
-                     } else {
-                        terrain = TileID::Grass;
-                     }
-                  }
+                  terrain = TileID::Grass;
                }
+            }
+         }
+
+         bool isSoil = (terrain == TileID::Grass || terrain == TileID::ColdGrass);
+
+         if (isSoil) {
+            if (m > 0.2f && treeRng > treeNoiseThreshold) {
+               placeTree = true;
+            } else if (terrain == TileID::ColdGrass && treeRng > 0.8f) {
+               terrain = TileID::HardGravel;   // Cold bushes
+            }
+         }
+      }
+
+      // Ores
+      if (terrain == TileID::Stone || terrain == TileID::HardStone) {
+         if (o > 0.8f) {
+            terrain = TileID::RedOre;
+         } else if (o < -0.8f) {
+            terrain = TileID::BlueOre;
+         }
+      }
+
+      return {terrain, computeTerrainHeight(h, terrain), placeTree};
+   }
+
+   // classifyTile for a whole row without branches: every rule is a masked select, applied from the weakest rule
+   // to the strongest, and masks are combined with & and |. selects go through bit masks rather than ?: so the
+   // compiler cannot turn them back into branches, and the loop vectorizes to the target's vector width.
+   // ids are 32 bit lanes, as wide as the float compares that select them
+   static void classifyRow(const RowSamples& row, ClassifiedRow& out) {
+      constexpr auto lane = [](const TileID id) { return static_cast<int32_t>(id); };
+
+      // results go to locals first: out could alias the samples as far as the compiler knows, and it will not
+      // vectorize behind a runtime overlap check at -O2
+      std::array<int32_t, Chunk::SIZE> ids;
+      std::array<float, Chunk::SIZE> heights;
+      std::array<int32_t, Chunk::SIZE> trees;
+      for (size_t i = 0; i < Chunk::SIZE; ++i) {
+         const float h = row.elevation[i];
+         const float t = row.temperature[i];
+         const float m = row.moisture[i];
+         const float r = row.river[i];
+         const float o = row.ore[i];
+         const float treeRng = row.trees[i];
+
+         const float dither = treeRng * 0.05f;
+         const float td = t + dither;
+         const float md = m + dither;
+
+         // standard biomes and the trees and bushes on their soil
+         int32_t biome = select(td < 0.1f, lane(TileID::ColdGrass), lane(TileID::Grass));
+         biome = select(md < -0.3f, lane(TileID::Gravel), biome);
+         biome = select((td > 0.4f) & (md < 0.1f), lane(TileID::BurntGround), biome);
+         biome = select((td > 0.4f) & (md < -0.2f), lane(TileID::Sand), biome);
+         biome = select(td < -0.3f, lane(TileID::Snow), biome);
+         const bool isSoil = (biome == lane(TileID::Grass)) | (biome == lane(TileID::ColdGrass));
+         const bool tree = isSoil & (m > 0.2f) & (treeRng > treeNoiseThreshold);
+         biome = select(!tree & (biome == lane(TileID::ColdGrass)) & (treeRng > 0.8f), lane(TileID::HardGravel), biome);
+
+         // high altitudes. ores before snow, snow replaces the stone the ores would have been set into
+         int32_t high = select(h > 0.85f, lane(TileID::HardStone), lane(TileID::Stone));
+         high = select(o < -0.8f, lane(TileID::BlueOre), high);
+         high = select(o > 0.8f, lane(TileID::RedOre), high);
+         high = select((td < -0.2f) | (h > 0.9f), lane(TileID::Snow), high);
+
+         // land, then rivers and oceans on top. the masks also stand in for comparing id against lists of tiles,
+         // which the compiler turns into a bit test with a variable shift that sse2 has no vector form of
+         const bool mountain = h > 0.7f;
+         const bool beach = h < 0.0f;
+         const bool river = (h > -0.1f) & (h < 0.5f) & (r > 0.85f);
+         const bool ocean = h < -0.1f;
+         int32_t id = select(mountain, high, biome);
+         id = select(beach, lane(TileID::Sand), id);
+         id = select(river, select(t < -0.5f, lane(TileID::Ice), lane(TileID::Water)), id);
+         id = select(ocean, select(t < 0.0f, select(t < -0.5f, lane(TileID::Ice), lane(TileID::ColdWater)), lane(TileID::Water)), id);
+         const bool isWater = ocean | river;
+
+         // computeTerrainHeight with the same operations in the same order, so heights match bit for bit
+         const float e = clamp(h, 0.0f, 1.0f);
+         float height = select(e < 0.7f, 0.6f + e * 0.5f, 1.2f + (e - 0.7f) * 2.0f);
+         height = select(id == lane(TileID::Planks), height + 0.8f, height);
+         height = select((id == lane(TileID::RedOre)) | (id == lane(TileID::BlueOre)), height + 0.4f, height);
+
+         ids[i] = id;
+         heights[i] = select(isWater, 0.5f, clamp(height, 0.0f, 2.0f));
+         // trees only grow where the standard biomes were kept
+         trees[i] = tree & !(mountain | beach | river | ocean);
+      }
+
+      for (size_t i = 0; i < Chunk::SIZE; ++i) {
+         out.ids[i] = static_cast<TileID>(ids[i]);
+         out.heights[i] = heights[i];
+         out.trees[i] = static_cast<uint8_t>(trees[i]);
+      }
+   }
+
+   // coarsest generation level, one sample per 8x8 tiles
+   static constexpr uint32_t maxLod = 3;
+
+private:
+   static constexpr float treeNoiseThreshold = 0.95f;
+
+   // a where mask is set, b elsewhere
+   static int32_t select(const bool mask, const int32_t a, const int32_t b) { return b ^ ((a ^ b) & -static_cast<int32_t>(mask)); }
+   static float select(const bool mask, const float a, const float b) { return std::bit_cast<float>(select(mask, std::bit_cast<int32_t>(a), std::bit_cast<int32_t>(b))); }
+   // std::clamp made of selects, std::min and std::max compile to branches that block vectorization
+   static float clamp(const float v, const float lo, const float hi) { return select(v < lo, lo, select(hi < v, hi, v)); }
+
+   // the tree noise dithers the biome and snow lines and places trees, all of which oceans, rivers and beaches
+   // override. mirrors the masks in classifyRow
+   static bool readsTreeNoise(const float h, const float r) { return !(h < 0.0f) & !((h > -0.1f) & (h < 0.5f) & (r > 0.85f)); }
+   // ore only replaces stone on mountains below the always snowed peaks
+   static bool readsOreNoise(const float h) { return (h > 0.7f) & !(h > 0.9f); }
+
+   struct NoiseMaps {
+      std::vector<float> elevation;
+      std::vector<float> river;
+      std::vector<float> temperature;
+      std::vector<float> moisture;
+      std::vector<float> ore;
+      std::vector<float> trees;
+      std::vector<float> lattice;   // coarse samples of the layer being upsampled
+      std::vector<float> latticeRow;
+      std::vector<float> positionsX;   // tiles a sparse layer is evaluated at, in noise space
+      std::vector<float> positionsY;
+      std::vector<uint32_t> positionIndices;
+      std::vector<float> positionValues;
+
+      void resize(const size_t area) {
+         for (std::vector<float>* map : {&elevation, &river, &temperature, &moisture, &ore, &trees}) {
+            map->resize(area);
+         }
+      }
+   };
+
+   static int latticeStep(const int step) { return static_cast<int>(std::bit_floor(static_cast<unsigned>(std::clamp(step, 1, static_cast<int>(Chunk::SIZE))))); }
+
+   // samples node every step tiles and fills the width x height map between the samples bilinearly. lattice points
+   // sit on multiples of step in world space, so a tile gets the same value whichever block it is generated in.
+   // offset is a multiple of step, being a multiple of Chunk::SIZE, and the lattice is one sample wider than the
+   // block on each axis to cover its last tiles
+   static void genLattice(const FastNoise::Generator& node, std::vector<float>& out, NoiseMaps& maps, const glm::ivec2 offset, const int width, const int height,
+                          const float frequency, const int noiseSeed, const int step) {
+      if (step == 1) {
+         node.GenUniformGrid2D(out.data(), offset.x, offset.y, width, height, frequency, noiseSeed);
+         return;
+      }
 
-               bool isSoil = (terrain == TileID::Grass || terrain == TileID::ColdGrass);
+      const int latticeWidth = width / step + 1;
+      const int latticeHeight = height / step + 1;
+      maps.lattice.resize(static_cast<size_t>(latticeWidth) * static_cast<size_t>(latticeHeight));
+      maps.latticeRow.resize(static_cast<size_t>(latticeWidth));
+      node.GenUniformGrid2D(maps.lattice.data(), offset.x / step, offset.y / step, latticeWidth, latticeHeight, frequency * static_cast<float>(step), noiseSeed);
+
+      const float invStep = 1.0f / static_cast<float>(step);
+      for (int y = 0; y < height; ++y) {
+         const float* top = &maps.lattice[static_cast<size_t>(y / step) * latticeWidth];
+         const float* bottom = top + latticeWidth;
+         const float fy = static_cast<float>(y % step) * invStep;
+         for (int c = 0; c < latticeWidth; ++c) {
+            maps.latticeRow[c] = top[c] + (bottom[c] - top[c]) * fy;
+         }
+
+         float* row = &out[static_cast<size_t>(y) * width];
+         for (int x = 0; x < width; ++x) {
+            const float left = maps.latticeRow[x / step];
+            const float right = maps.latticeRow[x / step + 1];
+            row[x] = left + (right - left) * (static_cast<float>(x % step) * invStep);
+         }
+      }
+   }
 
-               if (isSoil) {
-                  if (m > 0.2f && treeRng > treeNoiseThreshold) {
-                     placeTree = true;
-                  } else if (terrain == TileID::ColdGrass && treeRng > 0.8f) {
-                     terrain = TileID::HardGravel;   // Cold bushes
+   struct SparseBlock {
+      glm::ivec2 offset;
+      int width;
+      int chunkSamples;
+      glm::ivec2 blockSize;
+      std::span<Chunk* const> chunks;
+   };
+
+   // evaluates node at the tiles of the block's chunks that needs picks, as a position list, and leaves the rest of
+   // out at 0. chunks with no such tile cost nothing; once most of the block needs the layer the uniform grid is cheaper
+   template<typename Needs>
+   void genSparse(const FastNoise::Generator& node, std::vector<float>& out, NoiseMaps& maps, const SparseBlock& block, const float frequency, const int noiseSeed,
+                  Needs&& needs) {
+      maps.positionsX.clear();
+      maps.positionsY.clear();
+      maps.positionIndices.clear();
+      for (int by = 0; by < block.blockSize.y; ++by) {
+         for (int bx = 0; bx < block.blockSize.x; ++bx) {
+            if (!block.chunks[by * block.blockSize.x + bx]) {
+               continue;
+            }
+            for (int y = by * block.chunkSamples; y < (by + 1) * block.chunkSamples; ++y) {
+               for (int x = bx * block.chunkSamples; x < (bx + 1) * block.chunkSamples; ++x) {
+                  const auto i = static_cast<uint32_t>(y * block.width + x);
+                  if (needs(i)) {
+                     // the same products GenUniformGrid2D forms, so a tile samples the same value either way
+                     maps.positionsX.push_back(static_cast<float>(block.offset.x + x) * frequency);
+                     maps.positionsY.push_back(static_cast<float>(block.offset.y + y) * frequency);
+                     maps.positionIndices.push_back(i);
                   }
                }
             }
+         }
+      }
 
-            // Ores
-            if (terrain == TileID::Stone || terrain == TileID::HardStone) {
-               if (o > 0.8f) {
-                  terrain = TileID::RedOre;
-               } else if (o < -0.8f) {
-                  terrain = TileID::BlueOre;
+      const size_t area = out.size();
+      const size_t count = maps.positionIndices.size();
+      if (count * 4 >= area * 3) {
+         node.GenUniformGrid2D(out.data(), block.offset.x, block.offset.y, block.width, static_cast<int>(area) / block.width, frequency, noiseSeed);
+         evaluatedSamples.fetch_add(area, std::memory_order_relaxed);
+         return;
+      }
+
+      std::ranges::fill(out, 0.0f);
+      if (count != 0) {
+         maps.positionValues.resize(count);
+         node.GenPositionArray2D(maps.positionValues.data(), static_cast<int>(count), maps.positionsX.data(), maps.positionsY.data(), 0.0f, 0.0f, noiseSeed);
+         for (size_t k = 0; k < count; ++k) {
+            out[maps.positionIndices[k]] = maps.positionValues[k];
+         }
+      }
+      evaluatedSamples.fetch_add(count, std::memory_order_relaxed);
+      skippedSamples.fetch_add(area - count, std::memory_order_relaxed);
+   }
+
+   // classifies one chunk out of maps, which are stride samples wide; base is the chunk's first sample. above lod 0
+   // a sample row is widened to a tile row by repeating samples, classified once and written to 2^lod tile rows
+   static void fillChunk(Chunk& chunk, const NoiseMaps& maps, const int stride, const int base, const uint32_t lod) {
+      const glm::ivec2 offset = chunk.getPos() * Chunk::SIZE;
+      const int step = 1 << lod;
+
+      ClassifiedRow row;
+      std::array<std::array<float, Chunk::SIZE>, 6> widened;
+      for (int y = 0; y < Chunk::SIZE; y += step) {
+         const int idx = base + (y / step) * stride;
+         RowSamples samples{.elevation = &maps.elevation[idx],
+                            .river = &maps.river[idx],
+                            .temperature = &maps.temperature[idx],
+                            .moisture = &maps.moisture[idx],
+                            .ore = &maps.ore[idx],
+                            .trees = &maps.trees[idx]};
+         if (lod != 0) {
+            size_t layer = 0;
+            for (const float** samplesOf : {&samples.elevation, &samples.river, &samples.temperature, &samples.moisture, &samples.ore, &samples.trees}) {
+               for (int x = 0; x < Chunk::SIZE; ++x) {
+                  widened[layer][x] = (*samplesOf)[x / step];
                }
+               *samplesOf = widened[layer++].data();
             }
+         }
+         classifyRow(samples, row);
+         for (int dy = 0; dy < step; ++dy) {
+            chunk.setTerrainRow(y + dy, row.ids, row.heights);
+         }
 
-            const float height = computeTerrainHeight(h, terrain);
-            chunk.setTerrain(x, y, terrain, height);
-
-            if (placeTree) {
-               chunk.addEntity({.kind = EntityKind::Tree, .position = glm::vec3(static_cast<float>(offset.x + x) + 0.5f, static_cast<float>(offset.y + y) + 0.5f, height)});
+         for (int x = 0; x < Chunk::SIZE; x += step) {
+            if (row.trees[x]) {
+               chunk.addEntity({.kind = EntityKind::Tree, .position = glm::vec3(static_cast<float>(offset.x + x) + 0.5f, static_cast<float>(offset.y + y) + 0.5f, row.heights[x])});
             }
          }
       }
+      chunk.setLod(static_cast<uint8_t>(lod));
    }
 
-private:
    uint64_t seed{};
+   LayerResolution resolution;
+   std::shared_ptr<const NoiseGraph> noise;
+   std::atomic<uint64_t> evaluatedSamples{0};
+   std::atomic<uint64_t> skippedSamples{0};
 };
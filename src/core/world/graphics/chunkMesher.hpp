@@ -2,13 +2,13 @@
 
 #include "core/world/chunk.hpp"
 #include "core/world/contents/atlasCell.hpp"
-#include "core/world/graphics/worldRenderAdapter.hpp"
 #include "util/bitmask.hpp"
+#include "util/hash.hpp"
 
 #include <algorithm>
 #include <array>
-#include <memory>
-#include <random>
+#include <cstdint>
+#include <span>
 
 enum class AnalysisFlag : uint8_t {
    None = 0,
@@ -22,7 +22,7 @@ class ChunkMesher {
 private:
    static constexpr float EPSILON = 0.0001f;
    static constexpr int CHUNK_SIZE = Chunk::SIZE;
-   static constexpr int PADDED_SIZE = CHUNK_SIZE + 2;
+   static constexpr int PADDED_SIZE = Chunk::PADDED_SIZE;
 
    struct CachedTile {
       float height{};
@@ -50,69 +50,46 @@ private:
       }
    };
 
+public:
+   // public so brights_bench can time the copy and the topology pass apart
    struct MeshContext {
       std::array<CachedTile, PADDED_SIZE * PADDED_SIZE> buffer;
 
       MeshContext() = default;
 
-      void build(const Chunk& centerChunk, const std::array<std::shared_ptr<Chunk>, 8>& neighbors, const TileRegistry& tileRegistry) {
-         for (int y = 0; y < CHUNK_SIZE; ++y) {
-            const int centerRowOffset = y * CHUNK_SIZE;
-            const int bufferRowOffset = (y + 1) * PADDED_SIZE + 1;
-
-            for (int x = 0; x < CHUNK_SIZE; ++x) {
-               const int idx = centerRowOffset + x;
-               const TileID tID = centerChunk.terrainMap[idx];
-
-               buffer[bufferRowOffset + x] = {centerChunk.heightMap[idx], tileRegistry.get(tID).softness, tID};
-            }
-         }
-
-         auto copyTile = [&](int nIndex, int srcX, int srcY, int destX, int destY) {
-            if (const auto& chunk = neighbors[nIndex]) {
-               const int idx = srcY * CHUNK_SIZE + srcX;
-               const TileID id = chunk->terrainMap[idx];
-
-               buffer[destY * PADDED_SIZE + destX] = {chunk->heightMap[idx], tileRegistry.get(id).softness, id};
-            } else {
-               buffer[destY * PADDED_SIZE + destX] = {0.0f, 0.0f, TileID::Air};
-            }
-         };
-
-         for (int i = 0; i < CHUNK_SIZE; ++i) {
-            copyTile(1, i, CHUNK_SIZE - 1, i + 1, 0);         // North
-            copyTile(6, i, 0, i + 1, CHUNK_SIZE + 1);         // South
-            copyTile(3, CHUNK_SIZE - 1, i, 0, i + 1);         // West
-            copyTile(4, 0, i, CHUNK_SIZE + 1, i + 1);         // East
+      // the chunk's apron holds the neighbour ring, so the padded layout is copied as is
+      void build(const Chunk& chunk, const TileRegistry& tileRegistry) {
+         for (size_t i = 0; i < buffer.size(); ++i) {
+            const TileID id = chunk.tiles.id(i);
+            buffer[i] = {chunk.tiles.height(i), tileRegistry.get(id).softness, id};
          }
 
-         copyTile(0, CHUNK_SIZE - 1, CHUNK_SIZE - 1, 0, 0);   // NW
-         copyTile(2, 0, CHUNK_SIZE - 1, CHUNK_SIZE + 1, 0);   // NE
-         copyTile(5, CHUNK_SIZE - 1, 0, 0, CHUNK_SIZE + 1);   // SW
-         copyTile(7, 0, 0, CHUNK_SIZE + 1, CHUNK_SIZE + 1);   // SE
-
          analyzeTopology();
       }
 
       [[nodiscard]] const CachedTile& get(int x, int y) const { return buffer[(y + 1) * PADDED_SIZE + (x + 1)]; }
 
-   private:
+      // only ever adds flags, so running it again on the same buffer is harmless
       void analyzeTopology();
    };
 
-public:
-   static void meshChunk(Chunk& chunk, const TileRegistry& tileRegistry, std::mt19937& rng, const std::array<std::shared_ptr<Chunk>, 8>& neighbors,
-                         WorldRenderAdapter& renderAdapter) {
-      uint8_t* displayMapData = renderAdapter.getDisplayDataPtrForChunk(chunk.getPos());
-      uint16_t* packedMapData = renderAdapter.getPackedDataPtrForChunk(chunk.getPos());
+   // streamed and baked chunks have to agree on their tile variants
+   static constexpr uint64_t defaultVariationSeed = 42;
+
+   // the chunk's apron has to be complete. tile variants are a hash of the seed and the world tile,
+   // so any remesh of a chunk picks the same ones
+   static void meshChunk(const Chunk& chunk, const TileRegistry& tileRegistry, const uint64_t variationSeed, const std::span<uint8_t, Chunk::SIZE_SQUARED> displayMapData,
+                         const std::span<uint16_t, Chunk::SIZE_SQUARED> packedMapData) {
 
+      const glm::ivec2 origin = chunk.getPos() * CHUNK_SIZE;
       for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) {
-         const TileDefinition& def = tileRegistry.get(chunk.terrainMap[i]);
-         displayMapData[i] = packAtlasCell(getAtlasCell(def, rng));
+         const glm::ivec2 local{i % CHUNK_SIZE, i / CHUNK_SIZE};
+         const TileDefinition& def = tileRegistry.get(chunk.tiles.id(Chunk::tileIndex(local.x, local.y)));
+         displayMapData[i] = packAtlasCell(getAtlasCell(def, variationSeed, origin + local));
       }
 
       MeshContext ctx;
-      ctx.build(chunk, neighbors, tileRegistry);
+      ctx.build(chunk, tileRegistry);
 
       for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) {
          const int x = i % CHUNK_SIZE;
@@ -124,11 +101,12 @@ public:
    }
 
 private:
-   static glm::ivec2 getAtlasCell(const TileDefinition& def, std::mt19937& rng) {
+   static glm::ivec2 getAtlasCell(const TileDefinition& def, const uint64_t variationSeed, const glm::ivec2 worldTile) {
       glm::ivec2 cell = def.atlasBase;
       if (def.variationCount > 1) {
-         std::uniform_int_distribution<int> dist(0, def.variationCount - 1);
-         cell.y += dist(rng);
+         // scales the high 32 bits into [0, variationCount) without a division
+         const uint64_t bits = hashPosition(variationSeed, worldTile.x, worldTile.y) >> 32;
+         cell.y += static_cast<int>(bits * static_cast<uint64_t>(def.variationCount) >> 32);
       }
       return cell;
    }
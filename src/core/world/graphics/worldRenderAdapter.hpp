@@ -8,6 +8,7 @@
 #include <vector>
 #include <webgpu/webgpu.hpp>
 
+// with a null queue nothing is uploaded and the maps stay on the cpu, for headless runs like the bench
 class WorldRenderAdapter {
 public:
    WorldRenderAdapter(const wgpu::Queue queue, const wgpu::Buffer packedBuffer, const wgpu::Buffer tilemapBuffer, const wgpu::Buffer spriteBuffer):
@@ -18,7 +19,7 @@ public:
 
    uint32_t uploadStaticSprites(const std::vector<SpriteInstance>& sprites) {
       const uint32_t count = std::min(static_cast<uint32_t>(sprites.size()), staticSpriteCapacity);
-      if (count != 0) {
+      if (count != 0 && queue) {
          queue.writeBuffer(spriteBuffer, 0, sprites.data(), static_cast<size_t>(count) * sizeof(SpriteInstance));
       }
       return count;
@@ -26,7 +27,7 @@ public:
 
    uint32_t uploadDynamicSprites(const std::vector<SpriteInstance>& sprites) {
       const uint32_t count = std::min(static_cast<uint32_t>(sprites.size()), dynamicSpriteCapacity);
-      if (count != 0) {
+      if (count != 0 && queue) {
          constexpr uint64_t base = static_cast<uint64_t>(staticSpriteCapacity) * sizeof(SpriteInstance);
          queue.writeBuffer(spriteBuffer, base, sprites.data(), static_cast<size_t>(count) * sizeof(SpriteInstance));
       }
@@ -47,6 +48,10 @@ public:
          camera.setOffset(camera.getOffset() - glm::vec2(chunkMove * Chunk::SIZE));
       }
 
+      if (!queue) {
+         updatedChunkIndices.clear();
+      }
+
       std::sort(updatedChunkIndices.begin(), updatedChunkIndices.end());
       const auto duplicatesBegin = std::unique(updatedChunkIndices.begin(), updatedChunkIndices.end());
       updatedChunkIndices.erase(duplicatesBegin, updatedChunkIndices.end());
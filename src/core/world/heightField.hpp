@@ -1,45 +1,46 @@
 #pragma once
 
 #include "core/world/chunk.hpp"
+#include "core/world/chunkGrid.hpp"
 #include "core/world/contents/tile.hpp"
 
 #include <algorithm>
 #include <array>
 #include <glm/glm.hpp>
-#include <glm/gtx/hash.hpp>
-#include <memory>
 #include <optional>
-#include <unordered_map>
 
 // copies reconstructHeight from assets/shaders/terrain/heightfield.wgsl
 struct HeightField {
-   const std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>>& chunks;
+   const ChunkGrid& chunks;
    const TileRegistry& registry;
 
+   // the center tile first, then its ring
+   static constexpr std::array<glm::ivec2, 9> offsets{{{0, 0}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}, {0, 1}}};
+
    [[nodiscard]] std::optional<float> sampleAt(const glm::vec2 worldPos) const {
       const glm::ivec2 worldTile = static_cast<glm::ivec2>(glm::floor(worldPos));
 
-      static constexpr std::array<glm::ivec2, 9> offsets{{{0, 0}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}, {0, 1}}};
+      // the ring around a border tile comes from the chunk's apron, only the sides it touches have to be linked
+      const glm::ivec2 chunkPos = toChunkCoord(worldTile);
+      const Chunk* chunk = chunks.find(chunkPos);
+      if (!chunk) {
+         return std::nullopt;
+      }
+      const glm::ivec2 local = worldTile - chunkPos * Chunk::SIZE;
+      const glm::ivec2 side{local.x == 0 ? -1 : local.x == Chunk::SIZE - 1 ? 1 : 0, local.y == 0 ? -1 : local.y == Chunk::SIZE - 1 ? 1 : 0};
+      if ((side.x != 0 && !chunk->hasApron({side.x, 0})) || (side.y != 0 && !chunk->hasApron({0, side.y})) || (side.x != 0 && side.y != 0 && !chunk->hasApron(side))) {
+         return std::nullopt;
+      }
 
       std::array<float, 9> heights{};
-      float centerSoftness = 0.0f;
-
       for (int i = 0; i < 9; ++i) {
-         const glm::ivec2 nTile = worldTile + offsets[i];
-         const glm::ivec2 chunkPos = toChunkCoord(nTile);
-         const auto it = chunks.find(chunkPos);
-         if (it == chunks.end()) {
-            return std::nullopt;
-         }
-         const glm::ivec2 local = nTile - chunkPos * Chunk::SIZE;
-         heights[i] = it->second->heightAt(local.x, local.y);
-
-         if (i == 0) {
-            const TileID id = it->second->terrainAt(local.x, local.y);
-            centerSoftness = registry.get(id).softness;
-         }
+         heights[i] = chunk->heightAt(local.x + offsets[i].x, local.y + offsets[i].y);
       }
+      return reconstruct(heights, registry.get(chunk->terrainAt(local.x, local.y)).softness, worldPos - glm::vec2(worldTile));
+   }
 
+   // heights in offsets order, uv inside the center tile. public so brights_bench can time other lookups against it
+   [[nodiscard]] static float reconstruct(const std::array<float, 9>& heights, const float centerSoftness, const glm::vec2 uv) {
       const float centerH = heights[0];
       if (centerH <= 0.01f) {
          return 0.0f;
@@ -51,7 +52,6 @@ struct HeightField {
       }
       softness = std::min(softness, 0.5f);
 
-      const glm::vec2 uv = worldPos - glm::vec2(worldTile);
       if (uv.x >= softness && (1.0f - uv.x) >= softness && uv.y >= softness && (1.0f - uv.y) >= softness) {
          return centerH;
       }
@@ -5,17 +5,22 @@
 #include "core/world/chunk.hpp"
 #include "core/world/contents/entity.hpp"
 #include "core/world/contents/tile.hpp"
+#include "core/world/generation/noisePresets.hpp"
 #include "core/world/generation/worldGenerator.hpp"
 #include "core/world/graphics/planetGraphics.hpp"
 #include "core/world/graphics/shaderBindings.hpp"
 #include "core/world/graphics/worldRenderAdapter.hpp"
 #include "core/world/planetProjection.hpp"
+#include "core/world/streamingSettings.hpp"
 #include "core/world/worldArea.hpp"
 #include "render/gpuTexture.hpp"
 #include "util/threadpool.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <filesystem>
 #include <optional>
+#include <string>
 #include <webgpu/webgpu.hpp>
 
 struct PlanetConfig {
@@ -24,6 +29,8 @@ struct PlanetConfig {
    float baseSize = 1024.0f;
    glm::vec2 idleScrollSpeed{0.0f, 0.0f};   // tiles per second
    glm::vec2 orbitParams{0.0f, 0.0f};       // x: radius, y: speed
+   LayerResolution noiseResolution{};       // part of the terrain, like the seed: saved and baked chunks assume it
+   std::string preset{NoisePresets::defaultPreset};
 };
 
 struct PlanetContext {
@@ -36,31 +43,41 @@ struct PlanetContext {
    const GpuTexture& entitySheet;
    TileRegistry& tileRegistry;
    EntityRegistry& entityRegistry;
+   const NoisePresets& noisePresets;
+   std::filesystem::path worldDirectory;   // empty when edits are not persisted
 };
 
 class Planet {
 public:
    Planet(const PlanetConfig& config, const PlanetContext& ctx):
-      config(config), projection{config.baseSize * 0.5f}, generator(config.seed), gpu(ctx.device, ctx.queue, ctx.terrainLayout, ctx.spriteLayout, ctx.atlas, ctx.entitySheet),
+      config(config), projection{config.baseSize * 0.5f}, generator(config.seed, config.noiseResolution, ctx.noisePresets.get(config.preset)),
+      gpu(ctx.device, ctx.queue, ctx.terrainLayout, ctx.spriteLayout, ctx.atlas, ctx.entitySheet),
       renderAdapter(ctx.queue, gpu.packedBuffer(), gpu.tilemapBuffer(), gpu.spriteBuffer()),
-      worldArea(ctx.threadPool, ctx.tileRegistry, ctx.entityRegistry, generator, renderAdapter, Chunk::COUNT / 2, 0) {
+      worldArea(ctx.threadPool, ctx.tileRegistry, ctx.entityRegistry, generator, renderAdapter, Chunk::COUNT / 2, 0,
+                ctx.worldDirectory.empty() ? std::filesystem::path{} : ctx.worldDirectory / planetDirectoryName(config.seed, generator.getNoise().name, generator.getResolution())) {
       if (std::abs(config.orbitParams.x) > 0.001f) {
          currentOrbitAngle = std::atan2(config.position.y, config.position.x);
       }
    }
 
-   void update(const float dtSeconds, const bool focused, const glm::vec2 controlAxis, const std::optional<glm::vec2> cursorWorld) {
+   void update(const float dtSeconds, const bool focused, const glm::vec2 controlAxis, const std::optional<glm::vec2> cursorWorld,
+               const StreamingBudget& streamingBudget) {
       if (std::abs(config.orbitParams.x) > 0.001f) {
          currentOrbitAngle += config.orbitParams.y * dtSeconds;
          config.position.x = std::cos(currentOrbitAngle) * config.orbitParams.x;
          config.position.y = std::sin(currentOrbitAngle) * config.orbitParams.x;
       }
 
+      if (focused != wasFocused) {
+         worldArea.markStreamingEvent();
+         wasFocused = focused;
+      }
+
       if (!focused && glm::length(config.idleScrollSpeed) > 0.0001f) {
          localCamera.setOffset(localCamera.getOffset() + config.idleScrollSpeed * dtSeconds);
       }
 
-      worldArea.update(localCamera, chunkMove, dtSeconds, controlAxis, cursorWorld);
+      worldArea.update(localCamera, chunkMove, dtSeconds, controlAxis, cursorWorld, streamingBudget);
       renderAdapter.update(localCamera, chunkMove);
    }
 
@@ -94,6 +111,18 @@ public:
 
    [[nodiscard]] float getPixelsPerTile(float cameraScale) const { return projection.pixelsPerTile(cameraScale); }
 
+   // a level per halving of the tile size below fullDetailPixels, 0 at or above it or when fullDetailPixels is 0
+   [[nodiscard]] uint32_t generationLod(const float cameraScale, const float fullDetailPixels) const {
+      const float pixels = getPixelsPerTile(cameraScale);
+      if (fullDetailPixels <= 0.0f || pixels >= fullDetailPixels) {
+         return 0;
+      }
+      if (pixels <= 0.0f) {
+         return WorldGenerator::maxLod;
+      }
+      return std::min(static_cast<uint32_t>(std::ceil(std::log2(fullDetailPixels / pixels))), WorldGenerator::maxLod);
+   }
+
    [[nodiscard]] float getFocusScaleForPixelsPerTile(float targetPixelsPerTile) const { return projection.focusScaleForPixelsPerTile(targetPixelsPerTile); }
 
 private:
@@ -132,6 +161,7 @@ private:
 
    float currentOrbitAngle = 0.0f;
    glm::ivec2 chunkMove{};
+   bool wasFocused = false;
 
    PlanetConfig config;
    PlanetProjection projection;
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "core/world/chunk.hpp"
+#include "core/world/chunkCodec.hpp"
+#include "platform/mappedFile.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <glm/gtx/hash.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// chunks persisted on disk, one memory-mapped file per regionSize x regionSize block of chunks.
+// a file starts with a header and an index of (first sector, sector count, byte size) per chunk, blobs are ChunkCodec
+// output padded to whole sectors. a blob that outgrows its sectors moves to the end of the file, the old space is
+// not reclaimed. reads take a region shared, writes exclusively; a chunk staged for writing is served from memory
+// until a pool task has written it
+class RegionStore {
+public:
+   static constexpr int32_t regionSize = 16;
+
+   // an empty directory disables the store
+   explicit RegionStore(std::filesystem::path directory): directory(std::move(directory)) {}
+
+   RegionStore(const RegionStore&) = delete;
+   RegionStore(RegionStore&&) = delete;
+   RegionStore& operator =(const RegionStore&) = delete;
+   RegionStore& operator =(RegionStore&&) = delete;
+   ~RegionStore() { flush(); }
+
+   [[nodiscard]] bool enabled() const { return !directory.empty(); }
+
+   // the region holding chunk pos
+   [[nodiscard]] static glm::ivec2 regionPosOf(const glm::ivec2 pos) {
+      const auto floorDiv = [](const int v) { return v >= 0 ? v / regionSize : -((-v + regionSize - 1) / regionSize); };
+      return {floorDiv(pos.x), floorDiv(pos.y)};
+   }
+
+   // any thread. a corrupt blob is reported and leaves chunk blank. maps gets what brights_bake stored with the chunk
+   bool load(const glm::ivec2 pos, Chunk& chunk, const TileRegistry& tiles, const EntityRegistry& entities, std::optional<BakedMaps>* maps = nullptr) {
+      if (!enabled()) {
+         return false;
+      }
+      if (const std::shared_ptr<const std::vector<uint8_t>> blob = findPending(pos)) {
+         return decode(pos, *blob, chunk, tiles, entities, maps);
+      }
+
+      Region& region = regionOf(pos);
+      const std::shared_lock lock(region.mutex);
+      const std::span<const uint8_t> bytes = region.file.bytes();
+      if (bytes.empty()) {
+         return false;
+      }
+      const Entry entry = readEntry(bytes, localIndex(pos));
+      if (entry.bytes == 0) {
+         return false;
+      }
+      const size_t offset = static_cast<size_t>(entry.sector) * sectorSize;
+      if (offset + entry.bytes > bytes.size()) {
+         Logger::warn("region store: chunk {}, {} points past the end of its region", pos.x, pos.y);
+         return false;
+      }
+      return decode(pos, bytes.subspan(offset, entry.bytes), chunk, tiles, entities, maps);
+   }
+
+   // main thread. returns true when a writeBack(pos) has to be scheduled
+   bool stage(const glm::ivec2 pos, std::vector<uint8_t> blob) {
+      if (!enabled()) {
+         return false;
+      }
+      const std::lock_guard<std::mutex> lock(pendingMutex);
+      pending.insert_or_assign(pos, std::make_shared<const std::vector<uint8_t>>(std::move(blob)));
+      return true;
+   }
+
+   // any thread, writes the latest staged blob of pos. several calls for one staging are harmless
+   void writeBack(const glm::ivec2 pos) {
+      Region& region = regionOf(pos);
+      const std::unique_lock lock(region.mutex);
+      std::shared_ptr<const std::vector<uint8_t>> blob;
+      {
+         const std::lock_guard<std::mutex> pendingLock(pendingMutex);
+         const auto it = pending.find(pos);
+         if (it == pending.end()) {
+            return;
+         }
+         blob = std::move(it->second);
+         pending.erase(it);
+      }
+      if (write(region, pos, *blob)) {
+         written.fetch_add(1, std::memory_order_relaxed);
+      }
+   }
+
+   // any thread, skips staging. for tools that fill a store no game reads at the same time
+   bool writeNow(const glm::ivec2 pos, const std::span<const uint8_t> blob) {
+      if (!enabled()) {
+         return false;
+      }
+      Region& region = regionOf(pos);
+      const std::unique_lock lock(region.mutex);
+      if (!write(region, pos, blob)) {
+         return false;
+      }
+      written.fetch_add(1, std::memory_order_relaxed);
+      return true;
+   }
+
+   // writes everything staged on the calling thread
+   void flush() {
+      std::vector<glm::ivec2> positions;
+      {
+         const std::lock_guard<std::mutex> lock(pendingMutex);
+         for (const auto& [pos, blob] : pending) {
+            positions.push_back(pos);
+         }
+      }
+      for (const glm::ivec2 pos : positions) {
+         writeBack(pos);
+      }
+      const std::lock_guard<std::mutex> lock(regionsMutex);
+      for (const auto& [pos, region] : regions) {
+         const std::unique_lock regionLock(region->mutex);
+         region->file.flush();
+      }
+   }
+
+   [[nodiscard]] uint64_t loadedChunks() const { return loaded.load(std::memory_order_relaxed); }
+   [[nodiscard]] uint64_t writtenChunks() const { return written.load(std::memory_order_relaxed); }
+
+   [[nodiscard]] size_t pendingWrites() {
+      const std::lock_guard<std::mutex> lock(pendingMutex);
+      return pending.size();
+   }
+
+private:
+   struct Header {
+      uint32_t magic;
+      uint16_t version;
+      uint16_t regionSize;
+      uint32_t usedSectors;
+      uint32_t reserved;
+   };
+
+   struct Entry {
+      uint32_t sector;
+      uint32_t sectors;
+      uint32_t bytes;
+   };
+
+   static_assert(std::endian::native == std::endian::little, "region files are little endian");
+
+   static constexpr uint32_t magic = 0x47525242;   // "BRRG"
+   static constexpr uint16_t version = 1;
+   static constexpr size_t sectorSize = 256;
+   static constexpr size_t entryCount = regionSize * regionSize;
+   static constexpr uint32_t headerSectors = (sizeof(Header) + entryCount * sizeof(Entry) + sectorSize - 1) / sectorSize;
+   // a fresh region has room for a typical blob per chunk before its first remap
+   static constexpr size_t initialSectors = headerSectors + entryCount * 4;
+
+   struct Region {
+      std::shared_mutex mutex;
+      MappedFile file;   // empty until the first write when the file does not exist
+      std::filesystem::path path;
+   };
+
+   [[nodiscard]] static size_t localIndex(const glm::ivec2 pos) {
+      const glm::ivec2 local = pos - regionPosOf(pos) * regionSize;
+      return static_cast<size_t>(local.y * regionSize + local.x);
+   }
+
+   [[nodiscard]] static Header readHeader(const std::span<const uint8_t> bytes) {
+      Header header{};
+      std::memcpy(&header, bytes.data(), sizeof(Header));
+      return header;
+   }
+
+   static void writeHeader(const std::span<uint8_t> bytes, const Header& header) { std::memcpy(bytes.data(), &header, sizeof(Header)); }
+
+   [[nodiscard]] static Entry readEntry(const std::span<const uint8_t> bytes, const size_t index) {
+      Entry entry{};
+      std::memcpy(&entry, bytes.data() + sizeof(Header) + index * sizeof(Entry), sizeof(Entry));
+      return entry;
+   }
+
+   static void writeEntry(const std::span<uint8_t> bytes, const size_t index, const Entry& entry) {
+      std::memcpy(bytes.data() + sizeof(Header) + index * sizeof(Entry), &entry, sizeof(Entry));
+   }
+
+   // regions are opened on first use and stay open. a missing file is created by the first write
+   Region& regionOf(const glm::ivec2 pos) {
+      const glm::ivec2 regionPos = regionPosOf(pos);
+      const std::lock_guard<std::mutex> lock(regionsMutex);
+      std::unique_ptr<Region>& region = regions[regionPos];
+      if (region) {
+         return *region;
+      }
+      region = std::make_unique<Region>();
+      region->path = directory / std::format("r.{}.{}.region", regionPos.x, regionPos.y);
+      std::error_code error;
+      if (std::filesystem::exists(region->path, error) && !openRegion(*region)) {
+         region->file.close();
+      }
+      return *region;
+   }
+
+   static bool openRegion(Region& region) {
+      if (!region.file.open(region.path)) {
+         Logger::warn("region store: could not open '{}'", region.path.string());
+         return false;
+      }
+      const std::span<const uint8_t> bytes = region.file.bytes();
+      if (bytes.empty()) {
+         return true;
+      }
+      const Header header = bytes.size() >= headerSectors * sectorSize ? readHeader(bytes) : Header{};
+      if (header.magic != magic || header.version != version || header.regionSize != regionSize || header.usedSectors * sectorSize > bytes.size()) {
+         Logger::warn("region store: '{}' is not a region file of this version, it will be overwritten", region.path.string());
+         return region.file.resize(0);
+      }
+      return true;
+   }
+
+   // caller holds the region exclusively
+   bool write(Region& region, const glm::ivec2 pos, const std::span<const uint8_t> blob) {
+      if (!region.file.isOpen()) {
+         std::error_code error;
+         std::filesystem::create_directories(directory, error);
+         if (!region.file.open(region.path)) {
+            Logger::warn("region store: could not create '{}'", region.path.string());
+            return false;
+         }
+      }
+      if (region.file.size() == 0) {
+         if (!region.file.resize(initialSectors * sectorSize)) {
+            return false;
+         }
+         writeHeader(region.file.bytes(), {.magic = magic, .version = version, .regionSize = regionSize, .usedSectors = headerSectors, .reserved = 0});
+      }
+
+      Header header = readHeader(region.file.bytes());
+      const size_t index = localIndex(pos);
+      Entry entry = readEntry(region.file.bytes(), index);
+      const auto needed = static_cast<uint32_t>((blob.size() + sectorSize - 1) / sectorSize);
+      if (needed > entry.sectors) {
+         entry.sector = header.usedSectors;
+         entry.sectors = needed;
+         header.usedSectors += needed;
+         const size_t required = static_cast<size_t>(header.usedSectors) * sectorSize;
+         if (required > region.file.size() && !region.file.resize(std::max(required, region.file.size() * 3 / 2))) {
+            Logger::warn("region store: could not grow '{}'", region.path.string());
+            return false;
+         }
+      }
+      entry.bytes = static_cast<uint32_t>(blob.size());
+
+      const std::span<uint8_t> bytes = region.file.bytes();
+      std::ranges::copy(blob, bytes.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(entry.sector) * sectorSize));
+      writeEntry(bytes, index, entry);
+      writeHeader(bytes, header);
+      return true;
+   }
+
+   [[nodiscard]] std::shared_ptr<const std::vector<uint8_t>> findPending(const glm::ivec2 pos) {
+      const std::lock_guard<std::mutex> lock(pendingMutex);
+      const auto it = pending.find(pos);
+      return it == pending.end() ? nullptr : it->second;
+   }
+
+   bool decode(const glm::ivec2 pos, const std::span<const uint8_t> blob, Chunk& chunk, const TileRegistry& tiles, const EntityRegistry& entities,
+               std::optional<BakedMaps>* maps) {
+      if (!ChunkCodec::decode(blob, chunk, tiles, entities, maps)) {
+         Logger::warn("region store: chunk {}, {} is corrupt, regenerating", pos.x, pos.y);
+         chunk.reset(pos);
+         return false;
+      }
+      loaded.fetch_add(1, std::memory_order_relaxed);
+      return true;
+   }
+
+   std::filesystem::path directory;
+
+   std::mutex regionsMutex;
+   std::unordered_map<glm::ivec2, std::unique_ptr<Region>> regions;
+
+   std::mutex pendingMutex;
+   std::unordered_map<glm::ivec2, std::shared_ptr<const std::vector<uint8_t>>> pending;
+
+   std::atomic<uint64_t> loaded{0};
+   std::atomic<uint64_t> written{0};
+};
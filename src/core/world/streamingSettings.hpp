@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct StreamingSettings {
+   // main-thread time per frame for integrating finished chunk jobs, split across planets
+   int integrationBudgetUs = 2000;
+   // compressed recently unloaded chunks, split across planets. 0 disables the cache
+   int chunkCacheMB = 64;
+   // how far ahead of the camera motion spare workers generate chunks past the window. 0 disables prefetching
+   float prefetchSeconds = 1.0f;
+   // planets whose tiles are drawn smaller than this many pixels are generated coarser, one level per halving.
+   // 0 always generates full detail
+   float fullDetailPixelsPerTile = 2.0f;
+   // region files of each planet go to a subdirectory named after its seed and noise preset. empty disables persistence
+   std::string worldDirectory = "worlds";
+
+   static constexpr const char* key = "streaming";
+
+   template<typename Self, typename Fn>
+   static void forEachField(Self& self, Fn&& fn) {
+      fn("integrationBudgetUs", self.integrationBudgetUs);
+      fn("chunkCacheMB", self.chunkCacheMB);
+      fn("prefetchSeconds", self.prefetchSeconds);
+      fn("fullDetailPixelsPerTile", self.fullDetailPixelsPerTile);
+      fn("worldDirectory", self.worldDirectory);
+   }
+};
+
+// one planet's share of the streaming settings for a frame
+struct StreamingBudget {
+   std::chrono::microseconds integration{0};
+   size_t chunkCacheBytes = 0;
+   float prefetchSeconds = 0.0f;
+   uint32_t lod = 0;   // generation level for new chunks, see WorldGenerator::generateBlock
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+struct StreamingStats {
+   uint32_t loadedChunks = 0;
+   uint32_t queuedJobs = 0;
+   uint32_t inFlightJobs = 0;
+   uint64_t cancelledJobs = 0;   // dropped from the queue, skipped by a worker or discarded on arrival
+   uint32_t jobSlots = 0;        // thread pool arena size, flat once streaming is warm
+
+   // chunks held anywhere (window, lingering, in flight), their peak and the pool slots behind them
+   uint32_t liveChunks = 0;
+   uint32_t chunkHighWater = 0;
+   uint32_t pooledChunks = 0;
+   uint64_t chunkPoolBytes = 0;   // pool slots times sizeof(Chunk), entity spawns not included
+
+   // compressed unloaded chunks; a hit is a load served from the cache instead of the generator
+   uint64_t cacheHits = 0;
+   uint64_t cacheMisses = 0;
+   uint32_t cachedChunks = 0;
+   uint64_t cacheBytes = 0;
+
+   // chunks generated ahead of the camera motion, and chunks of the visible disk not meshed in the last frame
+   uint64_t prefetchedChunks = 0;
+   uint32_t visibleMissing = 0;
+
+   // generation level of new chunks, loaded chunks above full detail, and coarse chunks regenerated finer
+   uint32_t generationLod = 0;
+   uint32_t coarseChunks = 0;
+   uint64_t refinedChunks = 0;
+
+   // ore and tree noise samples the generator evaluated, and skipped because no tile's classification reads them
+   uint64_t sparseSamplesEvaluated = 0;
+   uint64_t sparseSamplesSkipped = 0;
+
+   // chunks read from and edits written to the on-disk region store, and baked chunks shown with their stored maps
+   uint64_t regionLoads = 0;
+   uint64_t regionWrites = 0;
+   uint64_t bakedMeshes = 0;
+
+   // finished results left for the next frame by the integration budget
+   uint32_t integrationBacklog = 0;
+   float lastIntegrationUs = 0.0f;
+
+   // average latency of a pipeline hop onto a worker and back onto the main thread, the latter includes frame waits
+   float workerHopUs = 0.0f;
+   float mainHopUs = 0.0f;
+
+   // from a teleport, focus switch or first load until the chunk under the camera is meshed
+   float timeToFirstVisibleMs = 0.0f;
+   bool waitingForFirstVisible = false;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/world/contents/tile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// full float heights, 5 bytes per tile
+template<size_t Count>
+class WideTileStorage {
+public:
+   // the stored height bits, for lossless serialization
+   using RawHeight = uint32_t;
+
+   [[nodiscard]] TileID id(const size_t i) const { return ids[i]; }
+   [[nodiscard]] float height(const size_t i) const { return heights[i]; }
+   [[nodiscard]] RawHeight rawHeight(const size_t i) const { return std::bit_cast<RawHeight>(heights[i]); }
+
+   void set(const size_t i, const TileID id, const float height) {
+      ids[i] = id;
+      heights[i] = height;
+   }
+
+   void setRaw(const size_t i, const TileID id, const RawHeight height) {
+      ids[i] = id;
+      heights[i] = std::bit_cast<float>(height);
+   }
+
+   void fill(const TileID id, const float height) {
+      ids.fill(id);
+      heights.fill(height);
+   }
+
+private:
+   std::array<TileID, Count> ids;
+   std::array<float, Count> heights;
+};
+
+// heights quantized to 16 bits over [0, maxTerrainHeight], 3 bytes per tile. a step is ~3e-5, far below the 8 bits
+// the gpu gets, so slow brush edits still register
+template<size_t Count>
+class CompactTileStorage {
+public:
+   using RawHeight = uint16_t;
+
+   [[nodiscard]] TileID id(const size_t i) const { return ids[i]; }
+   [[nodiscard]] float height(const size_t i) const { return static_cast<float>(heights[i]) * step; }
+   [[nodiscard]] RawHeight rawHeight(const size_t i) const { return heights[i]; }
+
+   void set(const size_t i, const TileID id, const float height) {
+      ids[i] = id;
+      heights[i] = quantize(height);
+   }
+
+   void setRaw(const size_t i, const TileID id, const RawHeight height) {
+      ids[i] = id;
+      heights[i] = height;
+   }
+
+   void fill(const TileID id, const float height) {
+      ids.fill(id);
+      heights.fill(quantize(height));
+   }
+
+private:
+   static constexpr float levels = 65535.0f;
+   static constexpr float step = maxTerrainHeight / levels;
+
+   static uint16_t quantize(const float height) { return static_cast<uint16_t>(std::lround(std::clamp(height, 0.0f, maxTerrainHeight) / step)); }
+
+   std::array<TileID, Count> ids;
+   std::array<uint16_t, Count> heights;
+};
+
+#ifdef BRIGHTS_WIDE_TILE_STORAGE
+template<size_t Count>
+using TileStorage = WideTileStorage<Count>;
+#else
+template<size_t Count>
+using TileStorage = CompactTileStorage<Count>;
+#endif
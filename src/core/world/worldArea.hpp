@@ -2,6 +2,11 @@
 
 #include "core/graphics/camera.hpp"
 #include "core/world/chunk.hpp"
+#include "core/world/chunkCache.hpp"
+#include "core/world/chunkCodec.hpp"
+#include "core/world/chunkGrid.hpp"
+#include "core/world/chunkJobQueue.hpp"
+#include "core/world/chunkPool.hpp"
 #include "core/world/contents/atlasCell.hpp"
 #include "core/world/contents/entity.hpp"
 #include "core/world/ecs/entitySimulation.hpp"
@@ -10,16 +15,28 @@
 #include "core/world/graphics/spriteInstance.hpp"
 #include "core/world/graphics/worldRenderAdapter.hpp"
 #include "core/world/heightField.hpp"
+#include "core/world/planetProjection.hpp"
+#include "core/world/regionStore.hpp"
+#include "core/world/streamingSettings.hpp"
+#include "core/world/streamingStats.hpp"
+#include "util/async.hpp"
+#include "util/logger.hpp"
 #include "util/threadpool.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <glm/gtx/hash.hpp>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <queue>
-#include <random>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -28,58 +45,123 @@
 class WorldArea {
 public:
    WorldArea(Threadpool& threadPool, TileRegistry& tileRegistry, const EntityRegistry& entityRegistry, WorldGenerator& worldGenerator, WorldRenderAdapter& renderAdapter,
-             uint32_t loadingRadius, uint32_t unloadingThreshold):
+             uint32_t loadingRadius, uint32_t unloadingThreshold, std::filesystem::path saveDirectory):
       loadingRadius(loadingRadius), unloadingThreshold(unloadingThreshold), threadPool(threadPool), tileRegistry(tileRegistry), worldGenerator(worldGenerator),
-      renderAdapter(renderAdapter), entityRegistry(entityRegistry) {}
+      renderAdapter(renderAdapter), entityRegistry(entityRegistry), regionStore(std::move(saveDirectory)) {
+      assert(2 * (loadingRadius + unloadingThreshold) <= static_cast<uint32_t>(ChunkGrid::SIZE));
+   }
+
+   // the pool must be drained first. loads that never reached a worker release the mesh jobs waiting for them,
+   // coroutines still parked in the main thread queue are destroyed with it. edits still loaded are written here
+   ~WorldArea() {
+      chunks.forEach([&](const Chunk& chunk) {
+         if (editedChunks.contains(chunk.getPos())) {
+            std::vector<uint8_t> blob;
+            ChunkCodec::encode(chunk, blob);
+            regionStore.stage(chunk.getPos(), std::move(blob));
+         }
+      });
+      regionStore.flush();
+
+      stopping.store(true, std::memory_order_relaxed);
+      for (const auto& [pos, load] : loads) {
+         publishGenerated(*load);
+      }
+   }
+
+   WorldArea(const WorldArea&) = delete;
+   WorldArea(WorldArea&&) = delete;
+   WorldArea& operator =(const WorldArea&) = delete;
+   WorldArea& operator =(WorldArea&&) = delete;
 
    [[nodiscard]] uint32_t getStaticSpriteCount() const { return staticSpriteCount; }
 
    [[nodiscard]] uint32_t getDynamicSpriteCount() const { return dynamicSpriteCount; }
 
-   void update(Camera& camera, const glm::ivec2& globalChunkMove, const float dtSeconds, const glm::vec2 controlAxis, const std::optional<glm::vec2> cursorWorld) {
-      processFinishedTasks();
+   [[nodiscard]] StreamingStats getStreamingStats() const {
+      StreamingStats stats = streamingStats;
+      stats.loadedChunks = static_cast<uint32_t>(chunks.size());
+      stats.queuedJobs = static_cast<uint32_t>(jobQueue.size());
+      stats.inFlightJobs = inFlightJobs;
+      stats.waitingForFirstVisible = firstVisibleWaitStart.has_value();
+      stats.integrationBacklog = static_cast<uint32_t>(mainThread.size());
+      stats.workerHopUs = workerHops.averageUs();
+      stats.mainHopUs = mainHops.averageUs();
+      stats.cancelledJobs = cancelledQueued + cancelledInFlight.load(std::memory_order_relaxed);
+      stats.jobSlots = threadPool.jobSlots();
+      stats.liveChunks = chunkPool.liveChunks();
+      stats.chunkHighWater = chunkPool.highWaterChunks();
+      stats.pooledChunks = chunkPool.capacity();
+      stats.chunkPoolBytes = static_cast<uint64_t>(stats.pooledChunks) * sizeof(Chunk);
+      stats.cacheHits = chunkCache.hitCount();
+      stats.cacheMisses = chunkCache.missCount();
+      stats.cachedChunks = static_cast<uint32_t>(chunkCache.size());
+      stats.cacheBytes = chunkCache.sizeBytes();
+      stats.sparseSamplesEvaluated = worldGenerator.evaluatedSparseSamples();
+      stats.sparseSamplesSkipped = worldGenerator.skippedSparseSamples();
+      stats.regionLoads = regionStore.loadedChunks();
+      stats.regionWrites = regionStore.writtenChunks();
+      stats.bakedMeshes = bakedMeshes.load(std::memory_order_relaxed);
+      stats.prefetchedChunks = prefetchedChunks;
+      stats.visibleMissing = countVisibleMissing();
+      stats.generationLod = generationLod;
+      chunks.forEach([&](const Chunk& chunk) { stats.coarseChunks += chunk.getLod() != 0 ? 1 : 0; });
+      stats.refinedChunks = refinedChunks;
+      return stats;
+   }
+
+   // restarts the time-to-first-visible-chunk measurement
+   void markStreamingEvent() { firstVisibleWaitStart = std::chrono::steady_clock::now(); }
+
+   void update(Camera& camera, const glm::ivec2& globalChunkMove, const float dtSeconds, const glm::vec2 controlAxis, const std::optional<glm::vec2> cursorWorld,
+               const StreamingBudget& budget) {
+      chunkCache.setBudget(budget.chunkCacheBytes);
+      setGenerationLod(budget.lod);
+      processFinishedTasks(budget.integration);
+      queueDeferredMeshing();
 
       const HeightField heightField{chunks, tileRegistry};
       simulation.update(camera, heightField, dtSeconds, controlAxis, cursorWorld, globalChunkMove);
 
       const glm::ivec2 cameraChunkPos = static_cast<glm::ivec2>(camera.getOffset()) / Chunk::SIZE + globalChunkMove;
+      if (!lastCameraChunkPos || cameraChunkPos != *lastCameraChunkPos) {
+         onCameraChunkChanged(cameraChunkPos);
+      }
+      trackCameraVelocity(camera.getOffset() + glm::vec2(globalChunkMove * Chunk::SIZE), dtSeconds);
 
       const glm::ivec2 bl = cameraChunkPos - static_cast<int32_t>(loadingRadius + unloadingThreshold);
       const glm::ivec2 ur = cameraChunkPos + static_cast<int32_t>(loadingRadius + unloadingThreshold);
 
-      for (auto it = chunks.begin(); it != chunks.end();) {
-         if (const glm::ivec2 cp = it->second->getPos(); cp.x < bl.x || cp.x >= ur.x || cp.y < bl.y || cp.y >= ur.y) {
-            if (pendingMeshing.contains(cp)) {
-               ++it;
-               continue;
-            }
-            staticDirty |= !it->second->getEntities().empty();
-            it = chunks.erase(it);
-         } else {
-            ++it;
+      chunks.eraseIf([&](const Chunk& chunk) {
+         const glm::ivec2 cp = chunk.getPos();
+         if (cp.x >= bl.x && cp.x < ur.x && cp.y >= bl.y && cp.y < ur.y) {
+            return false;
          }
-      }
+         if (pendingMeshing.contains(cp)) {
+            return false;
+         }
+         staticDirty |= !chunk.getEntities().empty();
+         retireChunk(chunk);
+         return true;
+      });
 
       for (int x = -static_cast<int32_t>(loadingRadius); std::cmp_less(x, loadingRadius); ++x) {
          for (int y = -static_cast<int32_t>(loadingRadius); std::cmp_less(y, loadingRadius); ++y) {
             const glm::ivec2 chunkPos = glm::ivec2{x, y} + cameraChunkPos;
 
-            if (chunks.contains(chunkPos) || pendingGeneration.contains(chunkPos)) {
+            if (chunks.contains(chunkPos) || loads.contains(chunkPos) || adoptPrefetched(chunkPos)) {
                continue;
             }
 
-            pendingGeneration.insert(chunkPos);
-
-            threadPool.enqueue([this, chunkPos]() {
-               auto newChunk = std::make_shared<Chunk>(chunkPos);
-               worldGenerator.generate(*newChunk);
-
-               const std::lock_guard<std::mutex> lock(resultsMutex);
-               finishedQueue.push({TaskResult::Type::Generated, newChunk});
-            });
+            queueGeneration(chunkPos);
          }
       }
 
+      dispatchJobs();
+      dispatchRefinement(cameraChunkPos);
+      dispatchPrefetch(cameraChunkPos, budget.prefetchSeconds);
+      trackFirstVisibleChunk(cameraChunkPos);
+
       if (staticDirty) {
          rebuildStaticSprites();
          staticDirty = false;
@@ -91,27 +173,30 @@ public:
 
    [[nodiscard]] std::optional<float> sampleHeight(const glm::ivec2 worldTile) const {
       const glm::ivec2 chunkPos = toChunkCoord(worldTile);
-      const auto it = chunks.find(chunkPos);
-      if (it == chunks.end()) {
+      const Chunk* chunk = chunks.find(chunkPos);
+      if (!chunk) {
          return std::nullopt;
       }
       const glm::ivec2 local = worldTile - chunkPos * Chunk::SIZE;
-      return it->second->heightAt(local.x, local.y);
+      return chunk->heightAt(local.x, local.y);
    }
 
-   [[nodiscard]] const Chunk* chunkAt(const glm::ivec2 chunkPos) const {
-      const auto it = chunks.find(chunkPos);
-      return it == chunks.end() ? nullptr : it->second.get();
-   }
+   [[nodiscard]] const Chunk* chunkAt(const glm::ivec2 chunkPos) const { return chunks.find(chunkPos); }
 
    bool setTerrain(const glm::ivec2 worldTile, const TileID id, const float height) {
       const glm::ivec2 chunkPos = toChunkCoord(worldTile);
-      const auto it = chunks.find(chunkPos);
-      if (it == chunks.end()) {
+      Chunk* chunk = chunks.find(chunkPos);
+      // a coarse chunk is replaced when it is refined, the edit would be lost
+      if (!chunk || chunk->getLod() != 0) {
          return false;
       }
       const glm::ivec2 local = worldTile - chunkPos * Chunk::SIZE;
-      it->second->setTerrain(local.x, local.y, id, height);
+      chunk->setTerrain(local.x, local.y, id, height);
+      editedChunks.insert(chunkPos);
+      bakedChunks.erase(chunkPos);
+      if (local.x == 0 || local.y == 0 || local.x == Chunk::SIZE - 1 || local.y == Chunk::SIZE - 1) {
+         forEachNeighbor(chunkPos, [&](Chunk& neighbor, const glm::ivec2 direction) { neighbor.copyApron(*chunk, -direction); });
+      }
       return true;
    }
 
@@ -142,115 +227,727 @@ public:
 private:
    void rebuildStaticSprites() {
       staticSprites.clear();
-      for (const auto& [pos, chunk] : chunks) {
-         for (const EntitySpawn& spawn : chunk->getEntities()) {
+      chunks.forEach([&](const Chunk& chunk) {
+         for (const EntitySpawn& spawn : chunk.getEntities()) {
             const EntityDefinition& def = entityRegistry.get(spawn.kind);
             staticSprites.push_back({.position = spawn.position, .rotation = 0.0f, .spriteDimensions = def.dimensions, .spriteId = packAtlasCell(def.spriteCell), .pivotY = 0.0f});
          }
-      }
+      });
       staticSpriteCount = renderAdapter.uploadStaticSprites(staticSprites);
    }
 
-   [[nodiscard]] std::optional<std::array<std::shared_ptr<Chunk>, 8>> collectNeighbors(const glm::ivec2 pos) const {
-      std::array<std::shared_ptr<Chunk>, 8> neighbors{};
-      int index = 0;
+   template<typename Fn>
+   void forEachNeighbor(const glm::ivec2 pos, Fn&& fn) {
       for (int dy = -1; dy <= 1; ++dy) {
          for (int dx = -1; dx <= 1; ++dx) {
-            if (dx == 0 && dy == 0) {
+            const glm::ivec2 direction{dx, dy};
+            if (direction == glm::ivec2{0, 0}) {
                continue;
             }
-            const auto it = chunks.find(pos + glm::ivec2{dx, dy});
-            if (it == chunks.end()) {
-               return std::nullopt;
+            if (Chunk* neighbor = chunks.find(pos + direction)) {
+               fn(*neighbor, direction);
             }
-            neighbors[index++] = it->second;
          }
       }
-      return neighbors;
+   }
+
+   // a new chunk and its loaded neighbours copy each other's facing edges into their aprons
+   void linkNeighbors(Chunk& chunk) {
+      forEachNeighbor(chunk.getPos(), [&](Chunk& neighbor, const glm::ivec2 direction) {
+         chunk.copyApron(neighbor, direction);
+         neighbor.copyApron(chunk, -direction);
+      });
+   }
+
+   // into the render adapter's slot of the chunk
+   void meshChunk(const Chunk& chunk) {
+      const glm::ivec2 pos = chunk.getPos();
+      ChunkMesher::meshChunk(chunk, tileRegistry, variationSeed, std::span<uint8_t, Chunk::SIZE_SQUARED>(renderAdapter.getDisplayDataPtrForChunk(pos), Chunk::SIZE_SQUARED),
+                             std::span<uint16_t, Chunk::SIZE_SQUARED>(renderAdapter.getPackedDataPtrForChunk(pos), Chunk::SIZE_SQUARED));
+   }
+
+   // a baked chunk whose block is unchanged since the bake gets the maps brights_bake meshed for it
+   void copyBakedMaps(const glm::ivec2 pos, const BakedMaps& maps) {
+      std::ranges::copy(maps.display, renderAdapter.getDisplayDataPtrForChunk(pos));
+      std::ranges::copy(maps.packed, renderAdapter.getPackedDataPtrForChunk(pos));
    }
 
    void remeshChunk(const glm::ivec2 pos) {
-      const auto it = chunks.find(pos);
-      if (it == chunks.end()) {
+      // the running job may have copied the terrain before the edit, and it writes the same render slot
+      if (pendingMeshing.contains(pos)) {
+         remeshAfterJob.insert(pos);
          return;
       }
-      const auto neighbors = collectNeighbors(pos);
-      if (!neighbors) {
+      Chunk* chunk = chunks.find(pos);
+      if (!chunk || !chunk->isApronComplete()) {
          return;
       }
-      std::seed_seq seed{pos.x, pos.y, chunkSeed};
-      std::mt19937 rng(seed);
-      ChunkMesher::meshChunk(*it->second, tileRegistry, rng, *neighbors, renderAdapter);
+      meshChunk(*chunk);
       renderAdapter.onChunkDataUpdated(pos);
    }
 
-   struct TaskResult {
-      enum class Type : uint8_t {
-         Generated,
-         Meshed
-      } type;
+   // what a mesh job reads, the center's interior and the facing edges of its eight neighbours copied into one
+   // chunk as each becomes available. a loaded chunk is copied on the main thread when the job starts, a loading
+   // one on the worker that generated it before it is integrated, so the job never reads a chunk that can change
+   struct MeshInputs {
+      explicit MeshInputs(std::shared_ptr<Chunk> terrain): terrain(std::move(terrain)) {}
+
+      // any thread. direction points from the center, a null chunk was dropped. baked chunks are as brights_bake
+      // wrote them, the center brings its maps unless it was meshed since. the nine calls write disjoint tiles,
+      // the last one to count down sets ready
+      void add(const std::shared_ptr<Chunk>& chunk, const glm::ivec2 direction, const bool baked, std::shared_ptr<const BakedMaps> maps) {
+         if (!baked) {
+            unbaked.store(true, std::memory_order_relaxed);
+         }
+         if (!chunk) {
+            complete.store(false, std::memory_order_relaxed);
+         } else if (direction == glm::ivec2{0, 0}) {
+            terrain->copyInterior(*chunk);
+            center = chunk;
+            bakedMaps = std::move(maps);
+         } else {
+            terrain->copyApronTiles(*chunk, direction);
+         }
+         if (missing.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.set();
+         }
+      }
+
+      std::shared_ptr<Chunk> terrain;   // its apron links are not recorded, the mesher does not read them
+      std::shared_ptr<Chunk> center;    // the chunk the mesh is for
+      std::shared_ptr<const BakedMaps> bakedMaps;   // the center's, only valid while no input is unbaked
+      std::atomic<int> missing{9};
+      std::atomic<bool> complete{true};
+      std::atomic<bool> unbaked{false};
+      AsyncEvent ready;
+   };
 
-      std::shared_ptr<Chunk> chunk;
+   struct MeshReader {
+      std::shared_ptr<MeshInputs> inputs;
+      glm::ivec2 direction;
    };
 
-   void processFinishedTasks() {
-      std::queue<TaskResult> finished;
+   // every chunk load is one coroutine from the priority queue to integration, and so is every mesh job. they hop
+   // to the pool for the heavy work and back to the main thread, where integration is bounded by the frame budget.
+   // a load is handed to a worker together with the other queued chunks of its aligned batch block
+   struct ChunkLoad {
+      explicit ChunkLoad(const glm::ivec2 pos): pos(pos) {}
+
+      glm::ivec2 pos;
+      std::shared_ptr<Chunk> chunk;   // null when cancelled or dropped
+      std::optional<std::vector<uint8_t>> cached;   // decoded instead of generated, handed back if the chunk is not used
+      bool prefetch = false;   // ahead of the window, parked next to the grid if the window has not caught up on arrival
+      bool refine = false;     // replaces a loaded coarser chunk
+      uint32_t lod = 0;        // generation level, restored chunks are full detail whatever it is
+      std::shared_ptr<const BakedMaps> bakedMaps;   // read with a baked chunk from the region store
+
+      std::mutex readersMutex;
+      bool generated = false;            // the chunk is final until it is integrated, or was given up
+      std::vector<MeshReader> readers;   // mesh jobs waiting to copy the chunk
+   };
+
+   AsyncJob loadBatch(std::vector<std::shared_ptr<ChunkLoad>> batch) {
+      co_await resumeOn(threadPool, &workerHops);
+      runGenerationBatch(batch);
+      for (const std::shared_ptr<ChunkLoad>& load : batch) {
+         publishGenerated(*load);
+      }
+
+      co_await mainThread.hop(&mainHops);
+      for (const std::shared_ptr<ChunkLoad>& load : batch) {
+         integrateGenerated(*load);
+      }
+   }
+
+   // waits for the last of its inputs, which resumes it on the worker that generated that chunk or on the main thread
+   AsyncJob meshJob(const glm::ivec2 pos, std::shared_ptr<MeshInputs> inputs) {
+      co_await inputs->ready;
+      if (stopping.load(std::memory_order_relaxed)) {
+         co_return;
+      }
+
+      std::shared_ptr<Chunk> chunk;
+      // a chunk outside the window may share its render buffer slot with a live one, never mesh it
+      if (inputs->complete.load(std::memory_order_relaxed) && isInsideWindow(pos, loadingRadius + unloadingThreshold)) {
+         co_await resumeOn(threadPool, &workerHops);
+         if (inputs->bakedMaps && !inputs->unbaked.load(std::memory_order_relaxed)) {
+            copyBakedMaps(pos, *inputs->bakedMaps);
+            bakedMeshes.fetch_add(1, std::memory_order_relaxed);
+         } else {
+            meshChunk(*inputs->terrain);
+         }
+         chunk = std::move(inputs->center);
+      } else {
+         cancelledInFlight.fetch_add(1, std::memory_order_relaxed);
+      }
+      inputs.reset();
+
+      co_await mainThread.hop(&mainHops);
+      integrateMeshed(pos, chunk);
+   }
+
+   // any thread, once per load. mesh jobs waiting for the chunk copy it before it reaches the main thread
+   static void publishGenerated(ChunkLoad& load) {
+      std::vector<MeshReader> readers;
+      {
+         const std::lock_guard<std::mutex> lock(load.readersMutex);
+         if (load.generated) {
+            return;
+         }
+         load.generated = true;
+         std::swap(readers, load.readers);
+      }
+      for (const MeshReader& reader : readers) {
+         reader.inputs->add(load.chunk, reader.direction, load.bakedMaps != nullptr, load.bakedMaps);
+      }
+   }
+
+   // main thread. a load that is still in the map is not integrated yet, so a published chunk can be copied here
+   static void readWhenGenerated(ChunkLoad& load, std::shared_ptr<MeshInputs> inputs, const glm::ivec2 direction) {
       {
-         const std::lock_guard<std::mutex> lock(resultsMutex);
-         std::swap(finished, finishedQueue);
+         const std::lock_guard<std::mutex> lock(load.readersMutex);
+         if (!load.generated) {
+            load.readers.push_back({std::move(inputs), direction});
+            return;
+         }
+      }
+      inputs->add(load.chunk, direction, load.bakedMaps != nullptr, load.bakedMaps);
+   }
+
+   // coroutines that do not fit into the budget wait for the next frame, at least one is resumed per call
+   void processFinishedTasks(const std::chrono::microseconds budget) {
+      const auto start = std::chrono::steady_clock::now();
+      const auto deadline = start + budget;
+
+      while (mainThread.resumeOne()) {
+         if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+         }
       }
 
-      while (!finished.empty()) {
-         const TaskResult result = finished.front();
-         finished.pop();
+      const std::chrono::duration<float, std::micro> spent = std::chrono::steady_clock::now() - start;
+      streamingStats.lastIntegrationUs = spent.count();
+   }
 
-         if (result.type == TaskResult::Type::Generated) {
-            chunks[result.chunk->getPos()] = result.chunk;
-            pendingGeneration.erase(result.chunk->getPos());
-            staticDirty |= !result.chunk->getEntities().empty();
+   // mesh jobs held back by the limit start once integration has made room
+   void queueDeferredMeshing() {
+      while (!deferredMeshing.empty() && pendingMeshing.size() < maxMeshingInFlight) {
+         const auto [pos, remesh] = *deferredMeshing.begin();
+         deferredMeshing.erase(deferredMeshing.begin());
+         tryQueueMeshing(pos, remesh);
+      }
+   }
 
-            for (int dy = -1; dy <= 1; ++dy) {
-               for (int dx = -1; dx <= 1; ++dx) {
-                  tryQueueMeshing(result.chunk->getPos() + glm::ivec2(dx, dy));
-               }
+   void integrateGenerated(ChunkLoad& load) {
+      --inFlightJobs;
+      loads.erase(load.pos);
+      insertGenerated(load);
+   }
+
+   void insertGenerated(ChunkLoad& load) {
+      if (!load.chunk) {
+         returnToCache(load);
+         return;
+      }
+      // finished after the camera left, the unload pass would throw it away anyway
+      if (!isInsideWindow(load.pos, loadingRadius + unloadingThreshold)) {
+         if (load.prefetch) {
+            parkPrefetched(load);
+            return;
+         }
+         ++cancelledQueued;
+         returnToCache(load);
+         return;
+      }
+      staticDirty |= !load.chunk->getEntities().empty();
+      // a chunk that lingered for its mesh job may still hold the slot on the far side of the torus. a refined
+      // chunk evicts the coarse one it replaces
+      if (const std::shared_ptr<Chunk> evicted = chunks.insert(load.chunk)) {
+         staticDirty |= !evicted->getEntities().empty();
+         retireChunk(*evicted);
+      }
+      if (load.bakedMaps) {
+         bakedChunks.insert_or_assign(load.pos, std::move(load.bakedMaps));
+      }
+      linkNeighbors(*load.chunk);
+      refineScanPending |= load.chunk->getLod() > generationLod;
+
+      // the new edges reach meshed neighbours through their aprons, and neighbours being meshed once their job is
+      // done. coarser ones are refined and meshed later anyway
+      if (load.refine) {
+         tryQueueMeshing(load.pos);
+         forEachNeighbor(load.pos, [&](const Chunk& neighbor, const glm::ivec2 /*direction*/) {
+            if ((neighbor.isMeshed() || pendingMeshing.contains(neighbor.getPos())) && neighbor.getLod() <= generationLod) {
+               tryQueueMeshing(neighbor.getPos(), true);
+            }
+         });
+      }
+
+      // the window caught up while it was generated, its neighbours' queueGeneration may have run without it
+      if (load.prefetch) {
+         for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+               tryQueueMeshing(load.pos + glm::ivec2(dx, dy));
             }
-         } else {
-            result.chunk->markMeshed();
-            pendingMeshing.erase(result.chunk->getPos());
-            renderAdapter.onChunkDataUpdated(result.chunk->getPos());
          }
       }
    }
 
-   void tryQueueMeshing(const glm::ivec2 pos) {
-      if (pendingMeshing.contains(pos)) {
+   // a prefetched chunk the window has not reached yet waits next to the grid. the chunks on the window's edge mesh
+   // against it right away, and the window takes it over without another load
+   void parkPrefetched(ChunkLoad& load) {
+      if (!isInsideWindow(load.pos, loadingRadius + maxPrefetchChunks)) {
+         chunkCache.store(*load.chunk);
+         load.chunk.reset();
+         return;
+      }
+      prefetched.insert_or_assign(load.pos, std::move(load.chunk));
+      for (int dy = -1; dy <= 1; ++dy) {
+         for (int dx = -1; dx <= 1; ++dx) {
+            tryQueueMeshing(load.pos + glm::ivec2(dx, dy));
+         }
+      }
+   }
+
+   bool adoptPrefetched(const glm::ivec2 pos) {
+      const auto it = prefetched.find(pos);
+      if (it == prefetched.end()) {
+         return false;
+      }
+      ChunkLoad load(pos);
+      load.chunk = std::move(it->second);
+      load.prefetch = true;
+      prefetched.erase(it);
+      insertGenerated(load);
+      return true;
+   }
+
+   // leaving chunks go to the compressed cache, edited ones are also written to the region store from the pool.
+   // neighbours stop sampling heights from their copy of its edge
+   void retireChunk(const Chunk& chunk) {
+      const glm::ivec2 pos = chunk.getPos();
+      forEachNeighbor(pos, [](Chunk& neighbor, const glm::ivec2 direction) { neighbor.unlinkApron(-direction); });
+      bakedChunks.erase(pos);
+      if (editedChunks.erase(pos) == 0) {
+         chunkCache.store(chunk);
+         return;
+      }
+      std::vector<uint8_t> blob;
+      ChunkCodec::encode(chunk, blob);
+      if (regionStore.stage(pos, blob)) {
+         threadPool.enqueue([this, pos] { regionStore.writeBack(pos); });
+      }
+      chunkCache.put(pos, std::move(blob));
+   }
+
+   // a cached load whose chunk was never used keeps its terrain and edits for the next visit
+   void returnToCache(ChunkLoad& load) {
+      if (load.cached) {
+         chunkCache.put(load.pos, std::move(*load.cached));
+         load.cached.reset();
+      }
+   }
+
+   void integrateMeshed(const glm::ivec2 pos, const std::shared_ptr<Chunk>& chunk) {
+      pendingMeshing.erase(pos);
+      const bool stale = remeshAfterJob.erase(pos) != 0;
+      // the generated chunk may have been discarded on arrival or replaced while the job ran,
+      // a replacement back inside the window needs a job of its own
+      const Chunk* current = chunks.find(pos);
+      if (!chunk || current != chunk.get()) {
+         if (current && !current->isMeshed() && isInsideWindow(pos, loadingRadius + unloadingThreshold)) {
+            tryQueueMeshing(pos);
+         }
          return;
       }
+      chunk->markMeshed();
+      renderAdapter.onChunkDataUpdated(pos);
+      // a later mesh has a changed block, the chunk only marks its neighbours' maps valid from here on
+      if (const auto baked = bakedChunks.find(pos); baked != bakedChunks.end()) {
+         baked->second.reset();
+      }
+      // the block changed after the job copied it
+      if (stale) {
+         tryQueueMeshing(pos, true);
+      }
+   }
+
+   void queueGeneration(const glm::ivec2 pos) {
+      const auto load = std::make_shared<ChunkLoad>(pos);
+      load->lod = generationLod;
+      load->cached = chunkCache.take(pos);
+      loads.emplace(pos, load);
+      jobQueue.push(pos);
+
+      for (int dy = -1; dy <= 1; ++dy) {
+         for (int dx = -1; dx <= 1; ++dx) {
+            tryQueueMeshing(pos + glm::ivec2(dx, dy));
+         }
+      }
+   }
 
-      const auto it = chunks.find(pos);
-      if (it == chunks.end() || it->second->isMeshed()) {
+   // starts a mesh job as soon as every chunk of the block is loaded or being loaded. remesh also redoes a meshed chunk,
+   // or the one being meshed once its job is done
+   void tryQueueMeshing(const glm::ivec2 pos, const bool remesh = false) {
+      if (pendingMeshing.contains(pos)) {
+         if (remesh) {
+            remeshAfterJob.insert(pos);
+         }
+         return;
+      }
+      if (!isInsideWindow(pos, loadingRadius + unloadingThreshold)) {
          return;
       }
 
-      const auto neighbors = collectNeighbors(pos);
-      if (!neighbors) {
+      if (const Chunk* center = chunks.find(pos); center && center->isMeshed() && !remesh) {
+         return;
+      }
+      // every job ends with a hop to the main thread queue, which only has room for so many. jobs of the window
+      // the camera left stay pending until they are integrated, so a pan can queue more than one window's worth
+      if (pendingMeshing.size() >= maxMeshingInFlight) {
+         deferredMeshing[pos] |= remesh;
          return;
       }
 
+      std::array<std::shared_ptr<Chunk>, 9> loaded;
+      std::array<ChunkLoad*, 9> pending{};
+      for (int i = 0; i < 9; ++i) {
+         const glm::ivec2 p = pos + glm::ivec2{i % 3 - 1, i / 3 - 1};
+         loaded[i] = chunks.findShared(p);
+         if (const auto parked = prefetched.find(p); !loaded[i] && parked != prefetched.end()) {
+            loaded[i] = parked->second;
+         }
+         if (loaded[i]) {
+            continue;
+         }
+         const auto load = loads.find(p);
+         if (load == loads.end()) {
+            return;
+         }
+         pending[i] = load->second.get();
+      }
+
+      const auto inputs = std::make_shared<MeshInputs>(chunkPool.acquire(pos));
+      for (int i = 0; i < 9; ++i) {
+         const glm::ivec2 direction{i % 3 - 1, i / 3 - 1};
+         if (pending[i]) {
+            readWhenGenerated(*pending[i], inputs, direction);
+         } else {
+            const auto baked = bakedChunks.find(pos + direction);
+            inputs->add(loaded[i], direction, baked != bakedChunks.end(), baked != bakedChunks.end() ? baked->second : nullptr);
+         }
+      }
       pendingMeshing.insert(pos);
+      meshJob(pos, inputs);
+   }
 
-      threadPool.enqueue([this, chunk = it->second, neighbors = *neighbors]() {
-         std::seed_seq seed{chunk->getPos().x, chunk->getPos().y, chunkSeed};
-         std::mt19937 rng(seed);
+   void onCameraChunkChanged(const glm::ivec2 cameraChunkPos) {
+      // a jump of more than one chunk is a teleport, not a pan
+      if (lastCameraChunkPos) {
+         const glm::ivec2 jump = glm::abs(cameraChunkPos - *lastCameraChunkPos);
+         if (std::max(jump.x, jump.y) > 1) {
+            markStreamingEvent();
+         }
+      }
+      lastCameraChunkPos = cameraChunkPos;
+      windowCenter.store(packChunkPos(cameraChunkPos), std::memory_order_relaxed);
+
+      // dropped loads are still published, mesh jobs waiting for them see the missing chunk and give up
+      jobQueue.eraseIf([&](const glm::ivec2 pos) {
+         if (isInsideWindow(pos, loadingRadius)) {
+            return false;
+         }
+         const auto it = loads.find(pos);
+         const std::shared_ptr<ChunkLoad> load = std::move(it->second);
+         loads.erase(it);
+         ++cancelledQueued;
+         returnToCache(*load);
+         publishGenerated(*load);
+         return true;
+      });
+
+      // parked chunks the camera turned away from go to the cache like unloaded ones
+      std::erase_if(prefetched, [&](const auto& entry) {
+         if (isInsideWindow(entry.first, loadingRadius + maxPrefetchChunks)) {
+            return false;
+         }
+         chunkCache.store(*entry.second);
+         return true;
+      });
+
+      // the rim the camera moves towards goes first
+      const auto visibleRadius = static_cast<int32_t>(static_cast<float>(loadingRadius) * PlanetProjection::sphereTileCoverage);
+      glm::vec2 lead = cameraVelocity * queueLeadSeconds / static_cast<float>(Chunk::SIZE);
+      if (const float length = glm::length(lead); length > static_cast<float>(visibleRadius / 2)) {
+         lead *= static_cast<float>(visibleRadius / 2) / length;
+      }
+      jobQueue.reprioritize(cameraChunkPos, visibleRadius, glm::ivec2(glm::round(lead)));
+   }
+
+   // generation jobs stay in the priority queue until a worker slot frees up, so a camera move can still reorder them.
+   // the best job takes every other queued chunk of its batch block along. in-flight jobs are counted in chunks,
+   // the main thread queue is sized for the mesh job limit plus the generation jobs in flight
+   void dispatchJobs() {
+      const uint32_t maxInFlight = generationLimit();
+      while (inFlightJobs < maxInFlight) {
+         const std::optional<glm::ivec2> pos = jobQueue.pop();
+         if (!pos) {
+            break;
+         }
+         const glm::ivec2 block = batchBlockOf(*pos);
+         std::vector<std::shared_ptr<ChunkLoad>> batch{loads.at(*pos)};
+         jobQueue.eraseIf([&](const glm::ivec2 other) {
+            if (batchBlockOf(other) != block) {
+               return false;
+            }
+            batch.push_back(loads.at(other));
+            return true;
+         });
+         inFlightJobs += static_cast<uint32_t>(batch.size());
+         loadBatch(std::move(batch));
+      }
+   }
+
+   [[nodiscard]] uint32_t generationLimit() const {
+      const uint32_t perWorker = 2 * generationBatch * generationBatch;
+      return std::clamp<uint32_t>(static_cast<uint32_t>(threadPool.activeWorkers()) * perWorker, 2, maxGenerationInFlight);
+   }
+
+   // smoothed camera motion in tiles per second, a jump of more than a chunk resets it
+   void trackCameraVelocity(const glm::vec2 cameraTile, const float dtSeconds) {
+      if (lastCameraTile && dtSeconds > 0.0f) {
+         const glm::vec2 step = cameraTile - *lastCameraTile;
+         if (glm::length(step) > static_cast<float>(Chunk::SIZE)) {
+            cameraVelocity = glm::vec2(0.0f);
+         } else {
+            const float blend = 1.0f - std::exp(-dtSeconds / velocitySmoothingSeconds);
+            cameraVelocity += (step / dtSeconds - cameraVelocity) * blend;
+         }
+      }
+      lastCameraTile = cameraTile;
+   }
+
+   // once the window itself is queued, spare generation slots go to the chunks the window will cover after
+   // lookaheadSeconds of the current motion, nearest first, so the ring just past the edge the camera moves
+   // towards comes first. they reuse the load pipeline, cached ones are decoded, and whatever arrives before the
+   // window does is parked next to the grid
+   void dispatchPrefetch(const glm::ivec2 cameraChunkPos, const float lookaheadSeconds) {
+      if (lookaheadSeconds <= 0.0f || jobQueue.size() != 0 || inFlightJobs >= generationLimit()) {
+         return;
+      }
+      glm::vec2 ahead = cameraVelocity * lookaheadSeconds / static_cast<float>(Chunk::SIZE);
+      const float distance = glm::length(ahead);
+      if (distance < 1.0f) {
+         return;
+      }
+      ahead *= std::min(distance, static_cast<float>(maxPrefetchChunks)) / distance;
+      const glm::ivec2 predicted = cameraChunkPos + glm::ivec2(glm::round(ahead));
+
+      prefetchCandidates.clear();
+      const auto r = static_cast<int32_t>(loadingRadius);
+      for (int y = predicted.y - r; y < predicted.y + r; ++y) {
+         for (int x = predicted.x - r; x < predicted.x + r; ++x) {
+            const glm::ivec2 pos{x, y};
+            if (!isInsideWindow(pos, loadingRadius) && !chunks.contains(pos) && !loads.contains(pos) && !prefetched.contains(pos)) {
+               prefetchCandidates.push_back(pos);
+            }
+         }
+      }
+      prefetchedChunks += dispatchExtraLoads(prefetchCandidates, cameraChunkPos, [&](ChunkLoad& load) {
+         load.prefetch = true;
+         load.lod = generationLod;
+         load.cached = chunkCache.take(load.pos);
+      });
+   }
 
-         ChunkMesher::meshChunk(*chunk, tileRegistry, rng, neighbors, renderAdapter);
+   // once the window itself is queued, spare generation slots regenerate loaded chunks coarser than the current
+   // level, nearest first. the coarse chunk stays in place until its replacement is integrated
+   void dispatchRefinement(const glm::ivec2 cameraChunkPos) {
+      if (!refineScanPending || jobQueue.size() != 0 || inFlightJobs >= generationLimit()) {
+         return;
+      }
+      refineCandidates.clear();
+      const auto r = static_cast<int32_t>(loadingRadius);
+      for (int y = cameraChunkPos.y - r; y < cameraChunkPos.y + r; ++y) {
+         for (int x = cameraChunkPos.x - r; x < cameraChunkPos.x + r; ++x) {
+            const Chunk* chunk = chunks.find({x, y});
+            if (chunk && chunk->getLod() > generationLod && !loads.contains(chunk->getPos())) {
+               refineCandidates.push_back(chunk->getPos());
+            }
+         }
+      }
+      // in-flight refinements set it again on arrival if they were not enough
+      refineScanPending = false;
 
-         const std::scoped_lock lock(resultsMutex);
-         finishedQueue.push({TaskResult::Type::Meshed, chunk});
+      refinedChunks += dispatchExtraLoads(refineCandidates, cameraChunkPos, [&](ChunkLoad& load) {
+         load.refine = true;
+         load.lod = generationLod;
       });
+      refineScanPending |= refineCandidates.size() != 0 && inFlightJobs >= generationLimit();
+   }
+
+   // loads for candidates outside the job queue, nearest to the camera first and each with the other candidates of
+   // its batch block, until the in-flight limit. configure marks them; returns how many were started
+   template<typename Configure>
+   size_t dispatchExtraLoads(std::vector<glm::ivec2>& candidates, const glm::ivec2 cameraChunkPos, Configure&& configure) {
+      const auto distanceSq = [&](const glm::ivec2 pos) {
+         const glm::ivec2 d = pos - cameraChunkPos;
+         return d.x * d.x + d.y * d.y;
+      };
+      std::ranges::sort(candidates, {}, distanceSq);
+
+      const uint32_t maxInFlight = generationLimit();
+      size_t started = 0;
+      for (const glm::ivec2 pos : candidates) {
+         if (inFlightJobs >= maxInFlight) {
+            break;
+         }
+         if (loads.contains(pos)) {
+            continue;
+         }
+         const glm::ivec2 block = batchBlockOf(pos);
+         std::vector<std::shared_ptr<ChunkLoad>> batch;
+         for (const glm::ivec2 other : candidates) {
+            if (batchBlockOf(other) == block && !loads.contains(other)) {
+               const auto load = std::make_shared<ChunkLoad>(other);
+               configure(*load);
+               loads.emplace(other, load);
+               batch.push_back(load);
+            }
+         }
+         inFlightJobs += static_cast<uint32_t>(batch.size());
+         started += batch.size();
+         loadBatch(std::move(batch));
+      }
+      return started;
+   }
+
+   // a finer level sends the loaded coarser chunks to refinement, a coarser one only applies to new chunks
+   void setGenerationLod(const uint32_t lod) {
+      const uint32_t level = std::min(lod, WorldGenerator::maxLod);
+      refineScanPending |= level < generationLod;
+      generationLod = level;
+   }
+
+   // chunks inside the projected disk that are not meshed yet, what the player sees as holes
+   [[nodiscard]] uint32_t countVisibleMissing() const {
+      if (!lastCameraChunkPos) {
+         return 0;
+      }
+      const auto visibleRadius = static_cast<int32_t>(static_cast<float>(loadingRadius) * PlanetProjection::sphereTileCoverage);
+      uint32_t missing = 0;
+      for (int y = -visibleRadius; y <= visibleRadius; ++y) {
+         for (int x = -visibleRadius; x <= visibleRadius; ++x) {
+            if (x * x + y * y > visibleRadius * visibleRadius) {
+               continue;
+            }
+            const Chunk* chunk = chunks.find(*lastCameraChunkPos + glm::ivec2{x, y});
+            missing += chunk == nullptr || !chunk->isMeshed() ? 1 : 0;
+         }
+      }
+      return missing;
    }
 
-   static constexpr int32_t chunkSeed = 42;
+   static glm::ivec2 batchBlockOf(const glm::ivec2 pos) {
+      const auto floorDiv = [](const int v) { return v >= 0 ? v / generationBatch : -((-v + generationBatch - 1) / generationBatch); };
+      return {floorDiv(pos.x), floorDiv(pos.y)};
+   }
+
+   // worker side. loads found in the cache or the region store are decoded, the generator samples only the
+   // bounding rectangle of the rest that are still inside the window, at the finest level among them
+   void runGenerationBatch(const std::vector<std::shared_ptr<ChunkLoad>>& batch) {
+      std::array<ChunkLoad*, generationBatch * generationBatch> generated{};
+      size_t generatedCount = 0;
+      uint32_t lod = WorldGenerator::maxLod;
+      glm::ivec2 lo{std::numeric_limits<int>::max()};
+      glm::ivec2 hi{std::numeric_limits<int>::min()};
+      for (const std::shared_ptr<ChunkLoad>& load : batch) {
+         if (!isInsideWindow(load->pos, load->prefetch ? loadingRadius + maxPrefetchChunks : loadingRadius)) {
+            cancelledInFlight.fetch_add(1, std::memory_order_relaxed);
+            continue;
+         }
+         load->chunk = chunkPool.acquire(load->pos);
+         if (restore(*load)) {
+            continue;
+         }
+         generated[generatedCount++] = load.get();
+         lod = std::min(lod, load->lod);
+         lo = glm::min(lo, load->pos);
+         hi = glm::max(hi, load->pos);
+      }
+      if (generatedCount == 0) {
+         return;
+      }
+
+      const glm::ivec2 size = hi - lo + 1;
+      std::array<Chunk*, generationBatch * generationBatch> targets{};
+      for (const ChunkLoad* load : std::span(generated.data(), generatedCount)) {
+         const glm::ivec2 local = load->pos - lo;
+         targets[local.y * size.x + local.x] = load->chunk.get();
+      }
+      worldGenerator.generateBlock(lo, size, std::span(targets.data(), static_cast<size_t>(size.x * size.y)), lod);
+   }
+
+   // false leaves a blank chunk for the generator
+   bool restore(ChunkLoad& load) {
+      if (load.cached) {
+         const bool restored = ChunkCodec::decode(*load.cached, *load.chunk, tileRegistry, entityRegistry);
+         load.cached.reset();
+         if (restored) {
+            return true;
+         }
+         Logger::warn("world area: corrupt cached chunk at {}, {}, regenerating", load.pos.x, load.pos.y);
+         load.chunk->reset(load.pos);
+      }
+      std::optional<BakedMaps> maps;
+      if (!regionStore.load(load.pos, *load.chunk, tileRegistry, entityRegistry, &maps)) {
+         return false;
+      }
+      if (maps) {
+         load.bakedMaps = std::make_shared<const BakedMaps>(*maps);
+      }
+      return true;
+   }
+
+   static uint64_t packChunkPos(const glm::ivec2 pos) { return static_cast<uint64_t>(static_cast<uint32_t>(pos.x)) << 32 | static_cast<uint32_t>(pos.y); }
+
+   static glm::ivec2 unpackChunkPos(const uint64_t packed) { return {static_cast<int32_t>(packed >> 32), static_cast<int32_t>(packed & 0xFFFFFFFFu)}; }
+
+   // safe from workers, the window center is published on every camera chunk change
+   [[nodiscard]] bool isInsideWindow(const glm::ivec2 pos, const uint32_t radius) const {
+      const glm::ivec2 d = pos - unpackChunkPos(windowCenter.load(std::memory_order_relaxed));
+      const auto r = static_cast<int32_t>(radius);
+      return d.x >= -r && d.x < r && d.y >= -r && d.y < r;
+   }
+
+   void trackFirstVisibleChunk(const glm::ivec2 cameraChunkPos) {
+      if (!firstVisibleWaitStart) {
+         return;
+      }
+      if (const Chunk* chunk = chunks.find(cameraChunkPos); !chunk || !chunk->isMeshed()) {
+         return;
+      }
+      const std::chrono::duration<float, std::milli> waited = std::chrono::steady_clock::now() - *firstVisibleWaitStart;
+      streamingStats.timeToFirstVisibleMs = waited.count();
+      firstVisibleWaitStart.reset();
+      Logger::debug("world area: first visible chunk after {:.2f} ms", streamingStats.timeToFirstVisibleMs);
+   }
+
+   // chunks per side of a generation batch block
+   static constexpr int32_t generationBatch = 2;
+   static constexpr uint32_t maxGenerationInFlight = 256;
+   // prefetching looks at most this many chunks past the window
+   static constexpr uint32_t maxPrefetchChunks = 8;
+   static constexpr float velocitySmoothingSeconds = 0.25f;
+   // how far ahead of the camera motion the job queue measures distances from
+   static constexpr float queueLeadSeconds = 0.5f;
+   // mesh jobs from queueing to integration, the rest wait in deferredMeshing
+   static constexpr size_t maxMeshingInFlight = Chunk::COUNT_SQUARED;
+   using MainThread = MainThreadQueue<2048>;
+   // each pending job has at most one hop queued, a batch may overshoot the in-flight limit by all but one of its chunks
+   static_assert(MainThread::capacity() >= maxMeshingInFlight + maxGenerationInFlight + generationBatch * generationBatch);
+
+   static constexpr uint64_t variationSeed = ChunkMesher::defaultVariationSeed;
 
    uint32_t loadingRadius = 0;
    uint32_t unloadingThreshold = 0;
@@ -267,10 +964,41 @@ private:
    uint32_t dynamicSpriteCount = 0;
    bool staticDirty = true;
 
-   std::queue<TaskResult> finishedQueue;
-   std::mutex resultsMutex;
-
-   std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>> chunks;
-   std::unordered_set<glm::ivec2> pendingGeneration;
+   // declared before everything that holds chunks, it has to outlive them
+   ChunkPool chunkPool;
+   MainThread mainThread;
+   HopStats workerHops;
+   HopStats mainHops;
+   std::atomic<bool> stopping{false};
+
+   ChunkGrid chunks;
+   ChunkCache chunkCache;
+   RegionStore regionStore;
+   std::unordered_set<glm::ivec2> editedChunks;   // loaded chunks changed since they were generated or read
+   // loaded chunks as brights_bake wrote them, with their maps until they are meshed
+   std::unordered_map<glm::ivec2, std::shared_ptr<const BakedMaps>> bakedChunks;
+   std::unordered_map<glm::ivec2, std::shared_ptr<ChunkLoad>> loads;
+   std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>> prefetched;   // arrived ahead of the window, outside the grid
    std::unordered_set<glm::ivec2> pendingMeshing;
+   std::unordered_set<glm::ivec2> remeshAfterJob;   // pending chunks whose block changed after their job copied it
+   std::unordered_map<glm::ivec2, bool> deferredMeshing;   // over the mesh job limit, true to remesh
+
+   ChunkJobQueue jobQueue;
+   uint32_t inFlightJobs = 0;
+   std::atomic<uint64_t> windowCenter{0};
+   std::atomic<uint64_t> cancelledInFlight{0};
+   std::atomic<uint64_t> bakedMeshes{0};
+   uint64_t cancelledQueued = 0;
+   std::optional<glm::ivec2> lastCameraChunkPos;
+   std::optional<glm::vec2> lastCameraTile;
+   glm::vec2 cameraVelocity{0.0f};
+   std::vector<glm::ivec2> prefetchCandidates;
+   uint64_t prefetchedChunks = 0;
+   uint32_t generationLod = 0;
+   bool refineScanPending = false;   // loaded chunks may be coarser than generationLod
+   std::vector<glm::ivec2> refineCandidates;
+   uint64_t refinedChunks = 0;
+
+   StreamingStats streamingStats;
+   std::optional<std::chrono::steady_clock::time_point> firstVisibleWaitStart = std::chrono::steady_clock::now();
 };
@@ -0,0 +1,142 @@
+#include "platform/mappedFile.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::filesystem::path& path) {
+   close();
+#if defined(_WIN32)
+   HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (handle == INVALID_HANDLE_VALUE) {
+      return false;
+   }
+   file = handle;
+   LARGE_INTEGER fileSize{};
+   if (!GetFileSizeEx(handle, &fileSize)) {
+      close();
+      return false;
+   }
+   length = static_cast<size_t>(fileSize.QuadPart);
+#else
+   fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+   if (fd < 0) {
+      return false;
+   }
+   struct stat info{};
+   if (fstat(fd, &info) != 0) {
+      close();
+      return false;
+   }
+   length = static_cast<size_t>(info.st_size);
+#endif
+   if (!map()) {
+      close();
+      return false;
+   }
+   return true;
+}
+
+bool MappedFile::resize(const size_t size) {
+   if (!isOpen()) {
+      return false;
+   }
+   unmap();
+#if defined(_WIN32)
+   LARGE_INTEGER target{};
+   target.QuadPart = static_cast<LONGLONG>(size);
+   if (!SetFilePointerEx(static_cast<HANDLE>(file), target, nullptr, FILE_BEGIN) || !SetEndOfFile(static_cast<HANDLE>(file))) {
+      map();
+      return false;
+   }
+#else
+   if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      map();
+      return false;
+   }
+#endif
+   length = size;
+   return map();
+}
+
+void MappedFile::flush() {
+   if (!data) {
+      return;
+   }
+#if defined(_WIN32)
+   FlushViewOfFile(data, 0);
+#else
+   msync(data, length, MS_ASYNC);
+#endif
+}
+
+void MappedFile::close() {
+   unmap();
+#if defined(_WIN32)
+   if (file) {
+      CloseHandle(static_cast<HANDLE>(file));
+      file = nullptr;
+   }
+#else
+   if (fd >= 0) {
+      ::close(fd);
+      fd = -1;
+   }
+#endif
+   length = 0;
+}
+
+bool MappedFile::isOpen() const {
+#if defined(_WIN32)
+   return file != nullptr;
+#else
+   return fd >= 0;
+#endif
+}
+
+// an empty file stays unmapped, neither platform maps zero bytes
+bool MappedFile::map() {
+   if (length == 0) {
+      return true;
+   }
+#if defined(_WIN32)
+   mapping = CreateFileMappingW(static_cast<HANDLE>(file), nullptr, PAGE_READWRITE, 0, 0, nullptr);
+   if (!mapping) {
+      return false;
+   }
+   data = static_cast<uint8_t*>(MapViewOfFile(static_cast<HANDLE>(mapping), FILE_MAP_ALL_ACCESS, 0, 0, length));
+   if (!data) {
+      CloseHandle(static_cast<HANDLE>(mapping));
+      mapping = nullptr;
+      return false;
+   }
+#else
+   void* view = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (view == MAP_FAILED) {
+      return false;
+   }
+   data = static_cast<uint8_t*>(view);
+#endif
+   return true;
+}
+
+void MappedFile::unmap() {
+   if (!data) {
+      return;
+   }
+#if defined(_WIN32)
+   UnmapViewOfFile(data);
+   CloseHandle(static_cast<HANDLE>(mapping));
+   mapping = nullptr;
+#else
+   munmap(data, length);
+#endif
+   data = nullptr;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <utility>
+
+// read-write mapping of a whole file, created if missing. resizing remaps, so spans taken before it dangle.
+// not synchronized, owners lock around resize
+class MappedFile {
+public:
+   MappedFile() = default;
+   ~MappedFile() { close(); }
+
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator =(const MappedFile&) = delete;
+   MappedFile(MappedFile&& other) noexcept { swap(other); }
+   MappedFile& operator =(MappedFile&& other) noexcept {
+      MappedFile moved(std::move(other));
+      swap(moved);
+      return *this;
+   }
+
+   bool open(const std::filesystem::path& path);
+   bool resize(size_t size);
+   // schedules dirty pages for writing, does not wait for the disk
+   void flush();
+   void close();
+
+   [[nodiscard]] bool isOpen() const;
+   [[nodiscard]] std::span<uint8_t> bytes() const { return {data, length}; }
+   [[nodiscard]] size_t size() const { return length; }
+
+private:
+   bool map();
+   void unmap();
+
+   void swap(MappedFile& other) noexcept {
+      std::swap(data, other.data);
+      std::swap(length, other.length);
+#if defined(_WIN32)
+      std::swap(file, other.file);
+      std::swap(mapping, other.mapping);
+#else
+      std::swap(fd, other.fd);
+#endif
+   }
+
+   uint8_t* data = nullptr;
+   size_t length = 0;
+#if defined(_WIN32)
+   void* file = nullptr;
+   void* mapping = nullptr;
+#else
+   int fd = -1;
+#endif
+};
@@ -0,0 +1,31 @@
+#include "platform/processMemory.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+size_t peakResidentBytes() {
+#if defined(_WIN32)
+   PROCESS_MEMORY_COUNTERS counters{};
+   if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+      return 0;
+   }
+   return counters.PeakWorkingSetSize;
+#else
+   rusage usage{};
+   if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+   }
+#if defined(__APPLE__)
+   return static_cast<size_t>(usage.ru_maxrss);
+#else
+   // kilobytes everywhere else
+   return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
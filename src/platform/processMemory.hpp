@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>
+
+// the most physical memory the process has used so far, 0 where unsupported
+size_t peakResidentBytes();
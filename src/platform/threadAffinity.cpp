@@ -0,0 +1,35 @@
+#include "platform/threadAffinity.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool setThreadAffinity(std::thread& thread, const std::optional<unsigned> core) {
+#if defined(_WIN32)
+   DWORD_PTR processMask = 0;
+   DWORD_PTR systemMask = 0;
+   if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+      return false;
+   }
+   const DWORD_PTR mask = core ? DWORD_PTR{1} << (*core % (sizeof(DWORD_PTR) * 8)) : processMask;
+   return SetThreadAffinityMask(static_cast<HANDLE>(thread.native_handle()), mask) != 0;
+#elif defined(__linux__)
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   if (core) {
+      CPU_SET(*core % CPU_SETSIZE, &set);
+   } else if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+      return false;
+   }
+   return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+   (void)thread;
+   (void)core;
+   return false;
+#endif
+}
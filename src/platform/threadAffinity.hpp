@@ -0,0 +1,7 @@
+#pragma once
+
+#include <optional>
+#include <thread>
+
+// pins thread to one logical core, or lets it float again when core is empty. returns false where unsupported
+bool setThreadAffinity(std::thread& thread, std::optional<unsigned> core);
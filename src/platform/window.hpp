@@ -121,6 +121,7 @@ private:
       case GLFW_KEY_F1:    return Key::F1;
       case GLFW_KEY_F2:    return Key::F2;
       case GLFW_KEY_F3:    return Key::F3;
+      case GLFW_KEY_F4:    return Key::F4;
       default:             return Key::Count;
       }
    }
@@ -0,0 +1,194 @@
+// offline planet bake: generates and meshes a rectangle of chunks centred on chunk 0, 0 on every core and writes
+// them, display and packed maps included, to the region files the game streams from. no window, no gpu
+//
+//    brights_bake <seed> <width> <height> [threads] [preset] [directory]
+//
+// width and height are in chunks, preset is temperate or one from the game's presets file, directory defaults to the
+// one the game uses for the seed and preset
+#include "core/world/chunk.hpp"
+#include "core/world/chunkCodec.hpp"
+#include "core/world/contents/defaultTiles.hpp"
+#include "core/world/generation/generatorSettings.hpp"
+#include "core/world/generation/noisePresets.hpp"
+#include "core/world/generation/worldGenerator.hpp"
+#include "core/world/graphics/chunkMesher.hpp"
+#include "core/world/regionStore.hpp"
+#include "platform/processMemory.hpp"
+#include "util/logger.hpp"
+#include "util/threadpool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct BakeOptions {
+   uint64_t seed = 0;
+   glm::ivec2 size{};
+   size_t threads = 1;
+   std::string preset;
+   std::filesystem::path directory;
+};
+
+struct BakeContext {
+   glm::ivec2 areaMin;
+   glm::ivec2 areaMax;
+   const TileRegistry& tileRegistry;
+   WorldGenerator& generator;
+   RegionStore& store;
+   std::atomic<uint64_t> chunks{0};
+   std::atomic<uint64_t> bytes{0};
+   std::atomic<uint64_t> failed{0};
+};
+
+template<typename T>
+std::optional<T> parseNumber(const std::string_view text) {
+   T value{};
+   const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+   if (error != std::errc{} || end != text.data() + text.size()) {
+      return std::nullopt;
+   }
+   return value;
+}
+
+std::optional<BakeOptions> parseOptions(const std::span<char* const> args) {
+   if (args.size() < 3 || args.size() > 6) {
+      return std::nullopt;
+   }
+   const std::optional<uint64_t> seed = parseNumber<uint64_t>(args[0]);
+   const std::optional<int> width = parseNumber<int>(args[1]);
+   const std::optional<int> height = parseNumber<int>(args[2]);
+   const std::optional<size_t> threads = args.size() > 3 ? parseNumber<size_t>(args[3]) : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+   if (!seed || !width || !height || !threads || *width <= 0 || *height <= 0 || *threads == 0) {
+      return std::nullopt;
+   }
+   const std::string preset = args.size() > 4 ? args[4] : std::string(NoisePresets::defaultPreset);
+   return BakeOptions{.seed = *seed,
+                      .size = {*width, *height},
+                      .threads = *threads,
+                      .preset = preset,
+                      // matches the game's StreamingSettings::worldDirectory default and Planet's subdirectory
+                      .directory = args.size() > 5 ? std::filesystem::path(args[5]) : std::filesystem::path("worlds") / planetDirectoryName(*seed, preset)};
+}
+
+// the region's chunks inside the area plus a ring around them for their aprons are generated as one block, so
+// regions bake independently and every region file has a single writer
+void bakeRegion(BakeContext& ctx, const glm::ivec2 regionPos) {
+   const glm::ivec2 lo = glm::max(regionPos * RegionStore::regionSize, ctx.areaMin);
+   const glm::ivec2 hi = glm::min((regionPos + 1) * RegionStore::regionSize, ctx.areaMax);
+   if (lo.x >= hi.x || lo.y >= hi.y) {
+      return;
+   }
+   const glm::ivec2 origin = lo - 1;
+   const glm::ivec2 blockSize = hi - lo + 2;
+
+   thread_local std::vector<Chunk> chunks;
+   thread_local std::vector<Chunk*> targets;
+   chunks.resize(static_cast<size_t>(blockSize.x) * static_cast<size_t>(blockSize.y));
+   targets.clear();
+   for (int y = 0; y < blockSize.y; ++y) {
+      for (int x = 0; x < blockSize.x; ++x) {
+         Chunk& chunk = chunks[y * blockSize.x + x];
+         chunk.reset(origin + glm::ivec2{x, y});
+         targets.push_back(&chunk);
+      }
+   }
+   ctx.generator.generateBlock(origin, blockSize, targets);
+
+   BakedMaps maps;
+   std::vector<uint8_t> blob;
+   for (int y = 1; y < blockSize.y - 1; ++y) {
+      for (int x = 1; x < blockSize.x - 1; ++x) {
+         Chunk& chunk = chunks[y * blockSize.x + x];
+         for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+               if (dx != 0 || dy != 0) {
+                  chunk.copyApron(chunks[(y + dy) * blockSize.x + x + dx], {dx, dy});
+               }
+            }
+         }
+         ChunkMesher::meshChunk(chunk, ctx.tileRegistry, ChunkMesher::defaultVariationSeed, maps.display, maps.packed);
+         ChunkCodec::encode(chunk, blob, &maps);
+         if (!ctx.store.writeNow(chunk.getPos(), blob)) {
+            ctx.failed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+         }
+         ctx.chunks.fetch_add(1, std::memory_order_relaxed);
+         ctx.bytes.fetch_add(blob.size(), std::memory_order_relaxed);
+      }
+   }
+}
+
+}   // namespace
+
+int main(const int argc, char** argv) {
+   const std::optional<BakeOptions> options = parseOptions(std::span<char* const>(argv, static_cast<size_t>(argc)).subspan(1));
+   if (!options) {
+      Logger::error("usage: brights_bake <seed> <width> <height> [threads] [preset] [directory]");
+      return 1;
+   }
+
+   // an unknown preset is an error here rather than the game's fallback, the bake would land in the wrong directory
+   NoisePresets presets;
+   if (options->preset != NoisePresets::defaultPreset && !presets.load(GeneratorSettings{}.presetsPath)) {
+      Logger::warn("some noise presets could not be loaded");
+   }
+   std::shared_ptr<const NoiseGraph> noise = presets.find(options->preset);
+   if (!noise) {
+      Logger::error("no noise preset '{}'", options->preset);
+      return 1;
+   }
+
+   TileRegistry tileRegistry;
+   registerDefaultTiles(tileRegistry);
+   WorldGenerator generator(options->seed, {}, std::move(noise));
+   RegionStore store(options->directory);
+
+   BakeContext ctx{.areaMin = -options->size / 2,
+                   .areaMax = -options->size / 2 + options->size,
+                   .tileRegistry = tileRegistry,
+                   .generator = generator,
+                   .store = store};
+   const glm::ivec2 firstRegion = RegionStore::regionPosOf(ctx.areaMin);
+   const glm::ivec2 lastRegion = RegionStore::regionPosOf(ctx.areaMax - 1);
+
+   Logger::info("baking {}x{} chunks of planet {} ({}) into '{}' on {} threads", options->size.x, options->size.y, options->seed, options->preset, options->directory.string(),
+                options->threads);
+   const auto start = std::chrono::steady_clock::now();
+   {
+      Threadpool pool(options->threads);
+      for (int y = firstRegion.y; y <= lastRegion.y; ++y) {
+         for (int x = firstRegion.x; x <= lastRegion.x; ++x) {
+            pool.enqueue([&ctx, regionPos = glm::ivec2{x, y}] { bakeRegion(ctx, regionPos); });
+         }
+      }
+      // shutdown drains the queue
+      pool.shutdown();
+   }
+   store.flush();
+   const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   const uint64_t baked = ctx.chunks.load();
+   Logger::info("baked {} chunks in {:.2f} s, {:.0f} chunks/s, {:.1f} MB of blobs, peak memory {:.1f} MB", baked, seconds, static_cast<double>(baked) / std::max(seconds, 1e-9),
+                static_cast<double>(ctx.bytes.load()) / (1024.0 * 1024.0), static_cast<double>(peakResidentBytes()) / (1024.0 * 1024.0));
+   const uint64_t skipped = generator.skippedSparseSamples();
+   const uint64_t sampled = skipped + generator.evaluatedSparseSamples();
+   Logger::info("skipped {} of {} ore and tree noise samples", skipped, sampled);
+   if (const uint64_t failed = ctx.failed.load(); failed != 0) {
+      Logger::error("{} chunks could not be written", failed);
+      return 1;
+   }
+   return 0;
+}
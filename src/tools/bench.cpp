@@ -0,0 +1,1009 @@
+// generation and meshing microbenchmarks without a window or gpu, results as json on stdout or into --out
+//
+//    brights_bench [--out file] [--filter substring] [--min-ms n]
+//
+// every case runs per seed, thread count or noise preset; compare runs of the same build type only. presets are read
+// from the game's presets file relative to the working directory, run it from the build directory
+//
+// some cases also check a property, e.g. that a warm thread pool enqueues without allocating; the run exits with 1
+// when one fails
+#include "core/world/chunk.hpp"
+#include "core/world/chunkCache.hpp"
+#include "core/world/chunkCodec.hpp"
+#include "core/world/chunkGrid.hpp"
+#include "core/world/contents/defaultEntities.hpp"
+#include "core/world/contents/defaultTiles.hpp"
+#include "core/world/generation/generatorSettings.hpp"
+#include "core/world/generation/noisePresets.hpp"
+#include "core/world/generation/worldGenerator.hpp"
+#include "core/world/graphics/chunkMesher.hpp"
+#include "core/world/heightField.hpp"
+#include "core/world/regionStore.hpp"
+#include "tools/benchHarness.hpp"
+#include "tools/heapCounter.hpp"
+#include "util/logger.hpp"
+#include "util/mpscRing.hpp"
+#include "util/threadpool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <glm/gtx/hash.hpp>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::array<uint64_t, 3> seeds{1, 1337, 90210};
+
+std::vector<size_t> threadCounts() {
+   const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+   std::vector<size_t> counts;
+   for (size_t n = 1; n < hardware; n *= 2) {
+      counts.push_back(n);
+   }
+   counts.push_back(hardware);
+   return counts;
+}
+
+BenchHarness::Param seedParam(const uint64_t seed) {
+   return {"seed", std::to_string(seed)};
+}
+
+BenchHarness::Param threadsParam(const size_t threads) {
+   return {"threads", std::to_string(threads)};
+}
+
+// width x width generated chunks from origin on; all but the outer ring have complete aprons
+class ChunkBlock {
+public:
+   ChunkBlock(WorldGenerator& generator, const glm::ivec2 origin, const int width): origin(origin), width(width) {
+      std::vector<Chunk*> targets;
+      for (int y = 0; y < width; ++y) {
+         for (int x = 0; x < width; ++x) {
+            chunks.push_back(std::make_shared<Chunk>(origin + glm::ivec2{x, y}));
+            targets.push_back(chunks.back().get());
+         }
+      }
+      generator.generateBlock(origin, {width, width}, targets);
+      for (int y = 1; y < width - 1; ++y) {
+         for (int x = 1; x < width - 1; ++x) {
+            for (int dy = -1; dy <= 1; ++dy) {
+               for (int dx = -1; dx <= 1; ++dx) {
+                  if (dx != 0 || dy != 0) {
+                     at(x, y).copyApron(at(x + dx, y + dy), {dx, dy});
+                  }
+               }
+            }
+            linked.push_back(&at(x, y));
+         }
+      }
+   }
+
+   [[nodiscard]] Chunk& at(const int x, const int y) { return *chunks[y * width + x]; }
+   [[nodiscard]] const Chunk& at(const int x, const int y) const { return *chunks[y * width + x]; }
+   [[nodiscard]] const std::vector<Chunk*>& inner() const { return linked; }
+   [[nodiscard]] const std::vector<std::shared_ptr<Chunk>>& all() const { return chunks; }
+
+   glm::ivec2 origin;
+   int width;
+
+private:
+   std::vector<std::shared_ptr<Chunk>> chunks;
+   std::vector<Chunk*> linked;
+};
+
+void benchGeneration(BenchHarness& bench) {
+   for (const uint64_t seed : seeds) {
+      WorldGenerator generator(seed);
+      Chunk chunk;
+      const bool single = bench.run("generate/chunk", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            chunk.reset({static_cast<int>(i % 64), static_cast<int>(i / 64)});
+            generator.generate(chunk);
+         }
+         keepAlive(chunk);
+         return iterations;
+      });
+      const double singlePerChunk = single ? bench.lastSecondsPerItem() : 0.0;
+
+      std::array<Chunk, 16> block;
+      std::array<Chunk*, 16> targets{};
+      for (size_t i = 0; i < block.size(); ++i) {
+         targets[i] = &block[i];
+      }
+      const auto runBlock = [&](const int width) {
+         const auto count = static_cast<size_t>(width * width);
+         const bool ran = bench.run("generate/block" + std::to_string(width) + "x" + std::to_string(width), {seedParam(seed)}, [&](const uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+               const glm::ivec2 origin{static_cast<int>(i % 16) * width, static_cast<int>(i / 16) * width};
+               for (size_t c = 0; c < count; ++c) {
+                  block[c].reset(origin + glm::ivec2{static_cast<int>(c) % width, static_cast<int>(c) / width});
+               }
+               generator.generateBlock(origin, {width, width}, std::span(targets).first(count));
+            }
+            keepAlive(block);
+            return iterations * count;
+         });
+         if (ran && singlePerChunk > 0.0 && bench.lastSecondsPerItem() > 0.0) {
+            bench.addMetric("speedupOverChunk", singlePerChunk / bench.lastSecondsPerItem());
+         }
+         return ran;
+      };
+      runBlock(2);
+      const uint64_t evaluatedBefore = generator.evaluatedSparseSamples();
+      const uint64_t skippedBefore = generator.skippedSparseSamples();
+      const bool ran = runBlock(4);
+      // share of the ore and tree samples a full grid evaluation would have taken that were skipped
+      const uint64_t skipped = generator.skippedSparseSamples() - skippedBefore;
+      const uint64_t sampled = skipped + generator.evaluatedSparseSamples() - evaluatedBefore;
+      if (ran && sampled != 0) {
+         bench.addMetric("sparseSkipped", static_cast<double>(skipped) / static_cast<double>(sampled));
+      }
+   }
+
+   // the coarse levels small and distant planets are generated at
+   for (uint32_t lod = 0; lod <= WorldGenerator::maxLod; ++lod) {
+      WorldGenerator generator(seeds[0]);
+      std::array<Chunk, 16> block;
+      std::array<Chunk*, 16> targets{};
+      for (size_t i = 0; i < block.size(); ++i) {
+         targets[i] = &block[i];
+      }
+      bench.run("generate/lod", {seedParam(seeds[0]), {"lod", std::to_string(lod)}}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            const glm::ivec2 origin{static_cast<int>(i % 16) * 4, static_cast<int>(i / 16) * 4};
+            for (int c = 0; c < 16; ++c) {
+               block[c].reset(origin + glm::ivec2{c % 4, c / 4});
+            }
+            generator.generateBlock(origin, {4, 4}, targets, lod);
+         }
+         keepAlive(block);
+         return iterations * 16;
+      });
+   }
+
+   // 4x4 blocks spread over the pool, the way WorldArea batches its loads
+   WorldGenerator generator(seeds[0]);
+   for (const size_t threads : threadCounts()) {
+      Threadpool pool(threads);
+      const auto blocksPerRun = static_cast<uint32_t>(threads * 4);
+      bench.run("generate/pool", {seedParam(seeds[0]), threadsParam(threads)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            std::latch done(blocksPerRun);
+            for (uint32_t b = 0; b < blocksPerRun; ++b) {
+               const glm::ivec2 origin{static_cast<int>(b) * 4, static_cast<int>(i % 64) * 4};
+               pool.enqueue([&generator, &done, origin] {
+                  thread_local std::array<Chunk, 16> block;
+                  thread_local std::array<Chunk*, 16> targets{};
+                  for (int c = 0; c < 16; ++c) {
+                     block[c].reset(origin + glm::ivec2{c % 4, c / 4});
+                     targets[c] = &block[c];
+                  }
+                  generator.generateBlock(origin, {4, 4}, targets);
+                  done.count_down();
+               });
+            }
+            done.wait();
+         }
+         return iterations * blocksPerRun * 16;
+      });
+   }
+}
+
+// 4x4 blocks with every preset of the game's presets file, temperate first so the others report their throughput
+// relative to it. presets differ in node count and in how many tiles read the sparse ore and tree layers
+void benchPresets(BenchHarness& bench) {
+   NoisePresets presets;
+   if (!presets.load(GeneratorSettings{}.presetsPath)) {
+      Logger::warn("some noise presets could not be loaded, they are left out");
+   }
+   std::vector<std::string> names = presets.names();
+   std::ranges::stable_partition(names, [](const std::string& name) { return name == NoisePresets::defaultPreset; });
+
+   double temperateSecondsPerItem = 0.0;
+   for (const std::string& name : names) {
+      WorldGenerator generator(seeds[0], {}, presets.find(name));
+      std::array<Chunk, 16> block;
+      std::array<Chunk*, 16> targets{};
+      for (size_t i = 0; i < block.size(); ++i) {
+         targets[i] = &block[i];
+      }
+      const bool ran = bench.run("generate/preset", {seedParam(seeds[0]), {"preset", BenchHarness::quote(name)}}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            const glm::ivec2 origin{static_cast<int>(i % 16) * 4, static_cast<int>(i / 16) * 4};
+            for (int c = 0; c < 16; ++c) {
+               block[c].reset(origin + glm::ivec2{c % 4, c / 4});
+            }
+            generator.generateBlock(origin, {4, 4}, targets);
+         }
+         keepAlive(block);
+         return iterations * 16;
+      });
+      if (!ran) {
+         continue;
+      }
+      const uint64_t skipped = generator.skippedSparseSamples();
+      const uint64_t sampled = skipped + generator.evaluatedSparseSamples();
+      bench.addMetric("sparseSkipped", sampled == 0 ? 0.0 : static_cast<double>(skipped) / static_cast<double>(sampled));
+      if (name == NoisePresets::defaultPreset) {
+         temperateSecondsPerItem = bench.lastSecondsPerItem();
+      } else if (temperateSecondsPerItem != 0.0 && bench.lastSecondsPerItem() != 0.0) {
+         bench.addMetric("relativeThroughput", temperateSecondsPerItem / bench.lastSecondsPerItem());
+      }
+   }
+
+   // what building a graph per generator or per job would cost, instead of once at startup
+   bench.run("generate/presetBuild", {{"preset", BenchHarness::quote(NoisePresets::defaultPreset)}}, [](const uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+         const NoisePresets built;
+         keepAlive(built);
+      }
+      return iterations;
+   });
+}
+
+// generation with the climate layers on coarser lattices, each compared tile for tile with a generator that samples
+// every tile. false when coarseClimate changes more tiles than maxClimateMismatch
+bool benchClimateResolution(BenchHarness& bench) {
+   constexpr double maxClimateMismatch = 0.002;
+   constexpr std::array<int, 5> steps{1, 2, 4, 8, 16};
+   constexpr int blocks = 8;
+
+   bool withinBound = true;
+   for (const uint64_t seed : seeds) {
+      WorldGenerator reference(seed, {.temperature = 1, .moisture = 1});
+      std::vector<ChunkBlock> expected;
+      for (int b = 0; b < blocks; ++b) {
+         expected.emplace_back(reference, glm::ivec2{b * 4 - 16, (b % 3) * 4 - 4}, 4);
+      }
+
+      for (const int step : steps) {
+         WorldGenerator generator(seed, {.temperature = step, .moisture = step});
+         std::array<Chunk, 16> block;
+         std::array<Chunk*, 16> targets{};
+         for (size_t i = 0; i < block.size(); ++i) {
+            targets[i] = &block[i];
+         }
+         const bool ran = bench.run("generate/climateLattice", {seedParam(seed), {"step", std::to_string(step)}}, [&](const uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+               const glm::ivec2 origin{static_cast<int>(i % 16) * 4, static_cast<int>(i / 16) * 4};
+               for (int c = 0; c < 16; ++c) {
+                  block[c].reset(origin + glm::ivec2{c % 4, c / 4});
+               }
+               generator.generateBlock(origin, {4, 4}, targets);
+            }
+            keepAlive(block);
+            return iterations * 16;
+         });
+         if (!ran) {
+            continue;
+         }
+
+         uint64_t tiles = 0;
+         uint64_t changed = 0;
+         int64_t treeDifference = 0;
+         for (const ChunkBlock& want : expected) {
+            const ChunkBlock got(generator, want.origin, 4);
+            for (size_t c = 0; c < got.all().size(); ++c) {
+               const Chunk& a = *got.all()[c];
+               const Chunk& b = *want.all()[c];
+               for (int y = 0; y < Chunk::SIZE; ++y) {
+                  for (int x = 0; x < Chunk::SIZE; ++x) {
+                     changed += a.terrainAt(x, y) != b.terrainAt(x, y) ? 1 : 0;
+                  }
+               }
+               tiles += Chunk::SIZE_SQUARED;
+               treeDifference += static_cast<int64_t>(a.getEntities().size()) - static_cast<int64_t>(b.getEntities().size());
+            }
+         }
+         const double mismatch = static_cast<double>(changed) / static_cast<double>(tiles);
+         bench.addMetric("tileMismatch", mismatch);
+         bench.addMetric("treeDifference", static_cast<double>(treeDifference));
+         if (step == coarseClimate.temperature && step == coarseClimate.moisture && mismatch > maxClimateMismatch) {
+            Logger::error("climate lattice step {} changes {:.3f}% of the tiles of seed {}, more than {:.3f}%", step, mismatch * 100.0, seed, maxClimateMismatch * 100.0);
+            withinBound = false;
+         }
+      }
+   }
+   return withinBound;
+}
+
+// rows of noise samples for the classification kernel: mostly uniform, one in four right at a rule's threshold or
+// one ulp to either side of it, where a reordered compare would show
+struct SampleRows {
+   static constexpr size_t rows = 256;
+   std::array<std::vector<float>, 6> layers;
+
+   explicit SampleRows(const uint64_t seed) {
+      constexpr std::array<float, 18> thresholds{-0.8f, -0.5f, -0.3f, -0.2f, -0.1f, 0.0f, 0.1f, 0.2f, 0.4f, 0.5f, 0.7f, 0.8f, 0.85f, 0.9f, 0.95f, 1.0f, 2.0f, -1.0f};
+      std::mt19937 rng(static_cast<uint32_t>(seed));
+      std::uniform_real_distribution<float> uniform(-1.2f, 1.2f);
+      std::uniform_int_distribution<size_t> pick(0, thresholds.size() * 3 * 4 - 1);
+      for (std::vector<float>& layer : layers) {
+         layer.resize(rows * Chunk::SIZE);
+         for (float& v : layer) {
+            const size_t choice = pick(rng);
+            if (choice >= thresholds.size() * 3) {
+               v = uniform(rng);
+               continue;
+            }
+            const float edge = thresholds[choice / 3];
+            v = choice % 3 == 0 ? edge : std::nextafter(edge, choice % 3 == 1 ? -2.0f : 2.0f);
+         }
+      }
+   }
+
+   [[nodiscard]] WorldGenerator::RowSamples row(const size_t r) const {
+      const size_t at = (r % rows) * Chunk::SIZE;
+      return {.elevation = &layers[0][at], .river = &layers[1][at], .temperature = &layers[2][at], .moisture = &layers[3][at], .ore = &layers[4][at], .trees = &layers[5][at]};
+   }
+};
+
+// classifyRow against classifyTile tile for tile over many seeds, then both timed. false on any mismatch
+bool benchClassification(BenchHarness& bench) {
+   if (!bench.selected("classify/")) {
+      return true;
+   }
+
+   constexpr uint64_t validationSeeds = 64;
+   uint64_t mismatches = 0;
+   WorldGenerator::ClassifiedRow out;
+   for (uint64_t seed = 0; seed < validationSeeds; ++seed) {
+      const SampleRows samples(seed);
+      for (size_t r = 0; r < SampleRows::rows; ++r) {
+         const WorldGenerator::RowSamples row = samples.row(r);
+         WorldGenerator::classifyRow(row, out);
+         for (size_t i = 0; i < Chunk::SIZE; ++i) {
+            const WorldGenerator::TileClass expected = WorldGenerator::classifyTile(row.elevation[i], row.temperature[i], row.moisture[i], row.river[i], row.ore[i], row.trees[i]);
+            if (out.ids[i] != expected.id || std::bit_cast<uint32_t>(out.heights[i]) != std::bit_cast<uint32_t>(expected.height) || (out.trees[i] != 0) != expected.tree) {
+               if (mismatches++ == 0) {
+                  Logger::error("classifyRow differs from classifyTile for seed {} row {} tile {}", seed, r, i);
+               }
+            }
+         }
+      }
+   }
+   if (mismatches != 0) {
+      Logger::error("{} of {} classified tiles differ", mismatches, validationSeeds * SampleRows::rows * Chunk::SIZE);
+   }
+
+   for (const uint64_t seed : seeds) {
+      const SampleRows samples(seed);
+      WorldGenerator::TileClass tile;
+      const bool scalar = bench.run("classify/scalar", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            const WorldGenerator::RowSamples row = samples.row(i);
+            for (size_t x = 0; x < Chunk::SIZE; ++x) {
+               tile = WorldGenerator::classifyTile(row.elevation[x], row.temperature[x], row.moisture[x], row.river[x], row.ore[x], row.trees[x]);
+               keepAlive(tile);
+            }
+         }
+         return iterations * Chunk::SIZE;
+      });
+      const double scalarPerTile = scalar ? bench.lastSecondsPerItem() : 0.0;
+
+      const bool vectorized = bench.run("classify/row", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            WorldGenerator::classifyRow(samples.row(i), out);
+            keepAlive(out);
+         }
+         return iterations * Chunk::SIZE;
+      });
+      if (vectorized) {
+         bench.addMetric("mismatches", static_cast<double>(mismatches));
+         if (scalarPerTile > 0.0 && bench.lastSecondsPerItem() > 0.0) {
+            bench.addMetric("speedupOverScalar", scalarPerTile / bench.lastSecondsPerItem());
+         }
+      }
+   }
+   return mismatches == 0;
+}
+
+// MeshContext::build as it was before chunks had aprons: the center tile by tile, then the facing rows and corners of
+// the eight neighbours in the order NW, N, NE, W, E, SW, S, SE. kept here as the baseline of mesh/build
+void buildFromNeighbours(ChunkMesher::MeshContext& ctx, const Chunk& center, const std::array<const Chunk*, 8>& neighbours, const TileRegistry& tileRegistry) {
+   constexpr int size = Chunk::SIZE;
+   const auto copyTile = [&](const Chunk& chunk, const int srcX, const int srcY, const int destX, const int destY) {
+      const TileID id = chunk.terrainAt(srcX, srcY);
+      ctx.buffer[static_cast<size_t>(destY * Chunk::PADDED_SIZE + destX)] = {chunk.heightAt(srcX, srcY), tileRegistry.get(id).softness, id};
+   };
+   for (int y = 0; y < size; ++y) {
+      for (int x = 0; x < size; ++x) {
+         copyTile(center, x, y, x + 1, y + 1);
+      }
+   }
+   for (int i = 0; i < size; ++i) {
+      copyTile(*neighbours[1], i, size - 1, i + 1, 0);
+      copyTile(*neighbours[6], i, 0, i + 1, size + 1);
+      copyTile(*neighbours[3], size - 1, i, 0, i + 1);
+      copyTile(*neighbours[4], 0, i, size + 1, i + 1);
+   }
+   copyTile(*neighbours[0], size - 1, size - 1, 0, 0);
+   copyTile(*neighbours[2], 0, size - 1, size + 1, 0);
+   copyTile(*neighbours[5], size - 1, 0, 0, size + 1);
+   copyTile(*neighbours[7], 0, 0, size + 1, size + 1);
+   ctx.analyzeTopology();
+}
+
+// meshChunk as it was before tile variants became a position hash: every mesh seeds an mt19937 from the chunk
+// position and draws the variants from it in tile order. kept here as the baseline of mesh/meshChunk
+void meshChunkMt19937(const Chunk& chunk, const TileRegistry& tileRegistry, BakedMaps& maps) {
+   constexpr int32_t chunkSeed = 42;
+   std::seed_seq seed{chunk.getPos().x, chunk.getPos().y, chunkSeed};
+   std::mt19937 rng(seed);
+   for (int i = 0; i < Chunk::SIZE_SQUARED; ++i) {
+      const TileDefinition& def = tileRegistry.get(chunk.terrainAt(i % Chunk::SIZE, i / Chunk::SIZE));
+      glm::ivec2 cell = def.atlasBase;
+      if (def.variationCount > 1) {
+         std::uniform_int_distribution<int> dist(0, def.variationCount - 1);
+         cell.y += dist(rng);
+      }
+      maps.display[i] = packAtlasCell(cell);
+   }
+
+   ChunkMesher::MeshContext ctx;
+   ctx.build(chunk, tileRegistry);
+   for (int i = 0; i < Chunk::SIZE_SQUARED; ++i) {
+      const auto& tile = ctx.get(i % Chunk::SIZE, i / Chunk::SIZE);
+      const auto h = static_cast<uint16_t>(std::clamp(tile.height * (255.0f / maxTerrainHeight), 0.0f, 255.0f));
+      const auto softness = static_cast<uint16_t>(std::clamp(tile.softness * 15.0f, 0.0f, 15.0f));
+      maps.packed[i] = static_cast<uint16_t>((h << 8) | (softness << 4) | (static_cast<uint8_t>(tile.rFlags) & 0x0F));
+   }
+}
+
+void benchMeshing(BenchHarness& bench, const TileRegistry& tileRegistry) {
+   for (const uint64_t seed : seeds) {
+      WorldGenerator generator(seed);
+      const ChunkBlock block(generator, {0, 0}, 6);
+      const std::vector<Chunk*>& chunks = block.inner();
+      std::vector<std::array<const Chunk*, 8>> neighbours;
+      for (const Chunk* chunk : chunks) {
+         const glm::ivec2 local = chunk->getPos() - block.origin;
+         std::array<const Chunk*, 8>& ring = neighbours.emplace_back();
+         size_t n = 0;
+         for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+               if (dx != 0 || dy != 0) {
+                  ring[n++] = &block.at(local.x + dx, local.y + dy);
+               }
+            }
+         }
+      }
+
+      auto ctx = std::make_unique<ChunkMesher::MeshContext>();
+      const bool gathered = bench.run("mesh/buildFromNeighbours", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            buildFromNeighbours(*ctx, *chunks[i % chunks.size()], neighbours[i % chunks.size()], tileRegistry);
+         }
+         keepAlive(*ctx);
+         return iterations;
+      });
+      const double gatheredPerChunk = gathered ? bench.lastSecondsPerItem() : 0.0;
+
+      const bool padded = bench.run("mesh/build", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            ctx->build(*chunks[i % chunks.size()], tileRegistry);
+         }
+         keepAlive(*ctx);
+         return iterations;
+      });
+      if (padded && gatheredPerChunk > 0.0 && bench.lastSecondsPerItem() > 0.0) {
+         bench.addMetric("speedupOverNeighbours", gatheredPerChunk / bench.lastSecondsPerItem());
+      }
+
+      ctx->build(*chunks[0], tileRegistry);
+      bench.run("mesh/analyzeTopology", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            ctx->analyzeTopology();
+         }
+         keepAlive(*ctx);
+         return iterations;
+      });
+
+      // display and packed maps as the render adapter receives them, variant selection included
+      BakedMaps maps;
+      const bool seeded = bench.run("mesh/meshChunkMt19937", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            meshChunkMt19937(*chunks[i % chunks.size()], tileRegistry, maps);
+         }
+         keepAlive(maps);
+         return iterations;
+      });
+      const double seededPerChunk = seeded ? bench.lastSecondsPerItem() : 0.0;
+
+      const bool hashed = bench.run("mesh/meshChunk", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            ChunkMesher::meshChunk(*chunks[i % chunks.size()], tileRegistry, ChunkMesher::defaultVariationSeed, maps.display, maps.packed);
+         }
+         keepAlive(maps);
+         return iterations;
+      });
+      if (hashed && seededPerChunk > 0.0 && bench.lastSecondsPerItem() > 0.0) {
+         bench.addMetric("speedupOverMt19937", seededPerChunk / bench.lastSecondsPerItem());
+      }
+   }
+}
+
+// sampleAt as it was before chunks had aprons: each tile of the 3x3 looked up on its own, find maps a chunk position
+// to the chunk or null. with a hash map it is the version from before the chunk grid as well
+template<typename Find>
+std::optional<float> sampleAtLookups(const Find& find, const TileRegistry& tileRegistry, const glm::vec2 worldPos) {
+   const glm::ivec2 worldTile = static_cast<glm::ivec2>(glm::floor(worldPos));
+   std::array<float, 9> heights{};
+   float centerSoftness = 0.0f;
+   for (size_t i = 0; i < heights.size(); ++i) {
+      const glm::ivec2 tile = worldTile + HeightField::offsets[i];
+      const glm::ivec2 chunkPos = toChunkCoord(tile);
+      const Chunk* chunk = find(chunkPos);
+      if (!chunk) {
+         return std::nullopt;
+      }
+      const glm::ivec2 local = tile - chunkPos * Chunk::SIZE;
+      heights[i] = chunk->heightAt(local.x, local.y);
+      if (i == 0) {
+         centerSoftness = tileRegistry.get(chunk->terrainAt(local.x, local.y)).softness;
+      }
+   }
+   return HeightField::reconstruct(heights, centerSoftness, worldPos - glm::vec2(worldTile));
+}
+
+void benchHeightField(BenchHarness& bench, const TileRegistry& tileRegistry) {
+   for (const uint64_t seed : seeds) {
+      WorldGenerator generator(seed);
+      const ChunkBlock block(generator, {-1, -1}, 6);
+      ChunkGrid grid;
+      for (const std::shared_ptr<Chunk>& chunk : block.all()) {
+         grid.insert(chunk);
+      }
+      std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>> map;
+      for (const std::shared_ptr<Chunk>& chunk : block.all()) {
+         map.emplace(chunk->getPos(), chunk);
+      }
+      const HeightField heightField{grid, tileRegistry};
+
+      std::mt19937 rng(static_cast<uint32_t>(seed));
+      std::uniform_real_distribution<float> coord(0.0f, 4.0f * Chunk::SIZE);
+      std::vector<glm::vec2> samples(4096);
+      for (glm::vec2& sample : samples) {
+         sample = {coord(rng), coord(rng)};
+      }
+
+      const auto findInMap = [&map](const glm::ivec2 pos) -> const Chunk* {
+         const auto it = map.find(pos);
+         return it == map.end() ? nullptr : it->second.get();
+      };
+      const bool hashed = bench.run("heightField/sampleAtHashMap", {seedParam(seed)}, [&](const uint64_t iterations) {
+         float sum = 0.0f;
+         for (uint64_t i = 0; i < iterations; ++i) {
+            sum += sampleAtLookups(findInMap, tileRegistry, samples[i % samples.size()]).value_or(0.0f);
+         }
+         keepAlive(sum);
+         return iterations;
+      });
+      const double hashedPerSample = hashed ? bench.lastSecondsPerItem() : 0.0;
+
+      const auto findInGrid = [&grid](const glm::ivec2 pos) { return grid.find(pos); };
+      const bool looked = bench.run("heightField/sampleAtGridLookups", {seedParam(seed)}, [&](const uint64_t iterations) {
+         float sum = 0.0f;
+         for (uint64_t i = 0; i < iterations; ++i) {
+            sum += sampleAtLookups(findInGrid, tileRegistry, samples[i % samples.size()]).value_or(0.0f);
+         }
+         keepAlive(sum);
+         return iterations;
+      });
+      const double lookedPerSample = looked ? bench.lastSecondsPerItem() : 0.0;
+
+      const bool padded = bench.run("heightField/sampleAt", {seedParam(seed)}, [&](const uint64_t iterations) {
+         float sum = 0.0f;
+         for (uint64_t i = 0; i < iterations; ++i) {
+            sum += heightField.sampleAt(samples[i % samples.size()]).value_or(0.0f);
+         }
+         keepAlive(sum);
+         return iterations;
+      });
+      if (padded && bench.lastSecondsPerItem() > 0.0) {
+         if (hashedPerSample > 0.0) {
+            bench.addMetric("speedupOverHashMap", hashedPerSample / bench.lastSecondsPerItem());
+         }
+         if (lookedPerSample > 0.0) {
+            bench.addMetric("speedupOverGridLookups", lookedPerSample / bench.lastSecondsPerItem());
+         }
+      }
+   }
+}
+
+// chunks of expected that a freshly opened store at directory does not give back exactly
+size_t countStoreMismatches(const std::filesystem::path& directory, const std::vector<Chunk*>& expected, const TileRegistry& tileRegistry,
+                            const EntityRegistry& entityRegistry) {
+   RegionStore store(directory);
+   std::vector<uint8_t> want;
+   std::vector<uint8_t> got;
+   Chunk loaded;
+   size_t mismatches = 0;
+   for (const Chunk* chunk : expected) {
+      loaded.reset(chunk->getPos());
+      if (!store.load(chunk->getPos(), loaded, tileRegistry, entityRegistry)) {
+         ++mismatches;
+         continue;
+      }
+      ChunkCodec::encode(*chunk, want);
+      ChunkCodec::encode(loaded, got);
+      mismatches += got != want ? 1 : 0;
+   }
+   return mismatches;
+}
+
+// four full regions of chunks around the origin go through the store the way the game writes them, staged
+// and written back or flushed, and come back after a reopen. then a third of them is rewritten bigger, which moves
+// their blobs to the end and grows the files, and a third smaller, which rewrites them in place
+bool checkRegionRoundTrip(const TileRegistry& tileRegistry, const EntityRegistry& entityRegistry) {
+   const std::filesystem::path directory = std::filesystem::temp_directory_path() / "brights-bench-roundtrip";
+   std::error_code error;
+   std::filesystem::remove_all(directory, error);
+
+   WorldGenerator generator(seeds[1]);
+   const ChunkBlock block(generator, {-RegionStore::regionSize - 1, -RegionStore::regionSize - 1}, 2 * RegionStore::regionSize + 2);
+   const std::vector<Chunk*>& chunks = block.inner();
+   const auto write = [&] {
+      RegionStore store(directory);
+      std::vector<uint8_t> blob;
+      for (size_t i = 0; i < chunks.size(); ++i) {
+         ChunkCodec::encode(*chunks[i], blob);
+         store.stage(chunks[i]->getPos(), blob);
+         if (i % 2 == 0) {
+            store.writeBack(chunks[i]->getPos());
+         }
+      }
+      store.flush();
+   };
+   const auto directoryBytes = [&] {
+      uintmax_t bytes = 0;
+      for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error)) {
+         bytes += entry.file_size(error);
+      }
+      return bytes;
+   };
+
+   bool roundTripped = true;
+   write();
+   if (const size_t mismatches = countStoreMismatches(directory, chunks, tileRegistry, entityRegistry); mismatches != 0) {
+      Logger::error("region store: {} of {} chunks came back different after the first write", mismatches, chunks.size());
+      roundTripped = false;
+   }
+   const uintmax_t firstBytes = directoryBytes();
+
+   std::mt19937 rng(static_cast<uint32_t>(seeds[1]));
+   std::uniform_real_distribution<float> height(0.0f, maxTerrainHeight);
+   for (size_t i = 0; i < chunks.size(); ++i) {
+      Chunk& chunk = *chunks[i];
+      for (int y = 0; y < Chunk::SIZE; ++y) {
+         for (int x = 0; x < Chunk::SIZE; ++x) {
+            if (i % 3 == 0) {
+               chunk.setTerrain(x, y, chunk.terrainAt(x, y), height(rng));
+            } else if (i % 3 == 1) {
+               chunk.setTerrain(x, y, chunk.terrainAt(0, 0), 0.0f);
+            }
+         }
+      }
+   }
+   write();
+   if (const size_t mismatches = countStoreMismatches(directory, chunks, tileRegistry, entityRegistry); mismatches != 0) {
+      Logger::error("region store: {} of {} chunks came back different after rewriting", mismatches, chunks.size());
+      roundTripped = false;
+   }
+   if (directoryBytes() <= firstBytes) {
+      Logger::error("region store: the grown chunks did not grow the region files, the round trip missed the relocation path");
+      roundTripped = false;
+   }
+
+   std::filesystem::remove_all(directory, error);
+   return roundTripped;
+}
+
+bool benchPersistence(BenchHarness& bench, const TileRegistry& tileRegistry, const EntityRegistry& entityRegistry) {
+   const bool roundTripped = !bench.selected("regionStore/roundTrip") || checkRegionRoundTrip(tileRegistry, entityRegistry);
+
+   for (const uint64_t seed : seeds) {
+      WorldGenerator generator(seed);
+      const ChunkBlock block(generator, {0, 0}, 6);
+      const std::vector<Chunk*>& chunks = block.inner();
+
+      std::vector<uint8_t> blob;
+      std::vector<std::vector<uint8_t>> blobs;
+      size_t total = 0;
+      for (const Chunk* chunk : chunks) {
+         ChunkCodec::encode(*chunk, blob);
+         total += blob.size();
+         blobs.push_back(blob);
+      }
+
+      const bool encoded = bench.run("codec/encode", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            ChunkCodec::encode(*chunks[i % chunks.size()], blob);
+         }
+         keepAlive(blob);
+         return iterations;
+      });
+      if (encoded) {
+         bench.addMetric("bytesPerChunk", static_cast<double>(total) / static_cast<double>(blobs.size()));
+      }
+
+      Chunk decoded;
+      bench.run("codec/decode", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            ChunkCodec::decode(blobs[i % blobs.size()], decoded, tileRegistry, entityRegistry);
+         }
+         keepAlive(decoded);
+         return iterations;
+      });
+
+      ChunkCache cache;
+      cache.setBudget(size_t{64} << 20);
+      bench.run("chunkCache/storeTake", {seedParam(seed)}, [&](const uint64_t iterations) {
+         for (uint64_t i = 0; i < iterations; ++i) {
+            const Chunk& chunk = *chunks[i % chunks.size()];
+            cache.store(chunk);
+            keepAlive(cache.take(chunk.getPos()));
+         }
+         return iterations;
+      });
+   }
+
+   // one full region on disk, read back by a growing number of threads
+   const std::filesystem::path directory = std::filesystem::temp_directory_path() / "brights-bench-regions";
+   std::error_code error;
+   std::filesystem::remove_all(directory, error);
+   {
+      WorldGenerator generator(seeds[0]);
+      const ChunkBlock block(generator, {-1, -1}, RegionStore::regionSize + 2);
+      RegionStore store(directory);
+      std::vector<uint8_t> blob;
+      for (const Chunk* chunk : block.inner()) {
+         ChunkCodec::encode(*chunk, blob);
+         store.writeNow(chunk->getPos(), blob);
+      }
+   }
+   RegionStore store(directory);
+   const auto load = [&](Chunk& chunk) { store.load(chunk.getPos(), chunk, tileRegistry, entityRegistry); };
+   for (const size_t threads : threadCounts()) {
+      Threadpool pool(threads);
+      bench.run("regionStore/load", {threadsParam(threads)}, [&](const uint64_t iterations) {
+         std::latch done(static_cast<std::ptrdiff_t>(threads));
+         for (size_t t = 0; t < threads; ++t) {
+            pool.enqueue([&load, &done, iterations, t, threads] {
+               thread_local Chunk chunk;
+               for (uint64_t i = t; i < iterations; i += threads) {
+                  const auto index = static_cast<int>(i % (RegionStore::regionSize * RegionStore::regionSize));
+                  chunk.reset({index % RegionStore::regionSize, index / RegionStore::regionSize});
+                  load(chunk);
+               }
+               done.count_down();
+            });
+         }
+         done.wait();
+         return iterations;
+      });
+   }
+   std::filesystem::remove_all(directory, error);
+   return roundTripped;
+}
+
+// the pool as it was before work stealing: one queue of std::function behind one mutex and condition variable.
+// kept here as the baseline of the threadpool cases
+class SharedQueuePool {
+public:
+   explicit SharedQueuePool(const size_t threads) {
+      for (size_t i = 0; i < threads; ++i) {
+         workers.emplace_back([this] {
+            for (;;) {
+               std::function<void()> task;
+               {
+                  std::unique_lock<std::mutex> lock(queueMutex);
+                  condition.wait(lock, [this] { return stop || !tasks.empty(); });
+                  if (stop && tasks.empty()) {
+                     return;
+                  }
+                  task = std::move(tasks.front());
+                  tasks.pop();
+               }
+               task();
+            }
+         });
+      }
+   }
+
+   template<class F>
+   void enqueue(F&& f) {
+      {
+         const std::unique_lock<std::mutex> lock(queueMutex);
+         tasks.emplace(std::forward<F>(f));
+      }
+      condition.notify_one();
+   }
+
+   ~SharedQueuePool() {
+      {
+         const std::unique_lock<std::mutex> lock(queueMutex);
+         stop = true;
+      }
+      condition.notify_all();
+      for (std::thread& worker : workers) {
+         worker.join();
+      }
+   }
+
+   SharedQueuePool(const SharedQueuePool&) = delete;
+   SharedQueuePool(SharedQueuePool&&) = delete;
+   SharedQueuePool& operator =(const SharedQueuePool&) = delete;
+   SharedQueuePool& operator =(SharedQueuePool&&) = delete;
+
+private:
+   std::vector<std::thread> workers;
+   std::queue<std::function<void()>> tasks;
+   std::mutex queueMutex;
+   std::condition_variable condition;
+   bool stop = false;
+};
+
+// contention grows with the workers, so the pools are compared at 1 to 32 whatever the hardware
+constexpr std::array<size_t, 6> poolSizes{1, 2, 4, 8, 16, 32};
+constexpr uint32_t tasksPerRun = 1024;
+constexpr uint32_t fanout = 32;
+
+// every task enqueued from outside, or a few that spawn the rest from the workers
+template<typename Pool>
+bool runPoolCase(BenchHarness& bench, std::string name, const size_t threads, Pool& pool, const bool spawn) {
+   return bench.run(std::move(name), {threadsParam(threads)}, [&](const uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+         std::latch done(tasksPerRun);
+         if (spawn) {
+            for (uint32_t t = 0; t < tasksPerRun / fanout; ++t) {
+               pool.enqueue([&pool, &done] {
+                  for (uint32_t c = 0; c < fanout; ++c) {
+                     pool.enqueue([&done] { done.count_down(); });
+                  }
+               });
+            }
+         } else {
+            for (uint32_t t = 0; t < tasksPerRun; ++t) {
+               pool.enqueue([&done] { done.count_down(); });
+            }
+         }
+         done.wait();
+      }
+      return iterations * tasksPerRun;
+   });
+}
+
+bool benchThreading(BenchHarness& bench) {
+   bool allocationFree = true;
+   for (const size_t threads : poolSizes) {
+      double sharedInject = 0.0;
+      double sharedSpawn = 0.0;
+      {
+         SharedQueuePool pool(threads);
+         sharedInject = runPoolCase(bench, "threadpool/sharedQueueInject", threads, pool, false) ? bench.lastSecondsPerItem() : 0.0;
+         sharedSpawn = runPoolCase(bench, "threadpool/sharedQueueSpawn", threads, pool, true) ? bench.lastSecondsPerItem() : 0.0;
+      }
+
+      // injected tasks go through the shared injection queue, spawned ones land in the workers' deques and get stolen
+      Threadpool pool(threads);
+      if (runPoolCase(bench, "threadpool/inject", threads, pool, false) && sharedInject > 0.0 && bench.lastSecondsPerItem() > 0.0) {
+         bench.addMetric("speedupOverSharedQueue", sharedInject / bench.lastSecondsPerItem());
+      }
+      if (runPoolCase(bench, "threadpool/spawn", threads, pool, true) && sharedSpawn > 0.0 && bench.lastSecondsPerItem() > 0.0) {
+         bench.addMetric("speedupOverSharedQueue", sharedSpawn / bench.lastSecondsPerItem());
+      }
+
+      // a warm pool must not touch the heap per enqueue. tasks capture a shared_ptr like the streaming jobs do, the
+      // injected ones spawn the rest from the workers, and the gate keeps a whole round in flight at once so the
+      // arena and the queues reach their peak during warm-up
+      const auto shared = std::make_shared<std::atomic<uint64_t>>(0);
+      const auto round = [&pool, &shared] {
+         std::latch gate(1);
+         std::latch done(tasksPerRun + tasksPerRun / fanout);
+         for (uint32_t t = 0; t < tasksPerRun / fanout; ++t) {
+            pool.enqueue([&pool, &gate, &done, shared] {
+               gate.wait();
+               for (uint32_t c = 0; c < fanout; ++c) {
+                  pool.enqueue([&done, shared] {
+                     shared->fetch_add(1, std::memory_order_relaxed);
+                     done.count_down();
+                  });
+               }
+               done.count_down();
+            });
+         }
+         gate.count_down();
+         done.wait();
+      };
+      for (int warm = 0; warm < 8; ++warm) {
+         round();
+      }
+      uint64_t allocations = 0;
+      const bool counted = bench.run("threadpool/enqueueAllocations", {threadsParam(threads)}, [&](const uint64_t iterations) {
+         const uint64_t before = heapAllocations();
+         for (uint64_t i = 0; i < iterations; ++i) {
+            round();
+         }
+         allocations = heapAllocations() - before;
+         return iterations * (tasksPerRun + tasksPerRun / fanout);
+      });
+      if (counted) {
+         bench.addMetric("allocations", static_cast<double>(allocations));
+         if (allocations != 0) {
+            Logger::error("a warm pool of {} threads allocated {} times while enqueueing", threads, allocations);
+            allocationFree = false;
+         }
+      }
+   }
+
+   for (const size_t threads : threadCounts()) {
+      // producers push into the ring the main thread integrates from
+      constexpr uint32_t pushesPerIteration = 4096;
+      bench.run("mpscRing/push", {{"producers", std::to_string(threads)}}, [&](const uint64_t iterations) {
+         auto ring = std::make_unique<MpscRing<uint32_t, 1024>>();
+         const uint64_t perProducer = iterations * pushesPerIteration;
+         std::vector<std::jthread> producers;
+         for (size_t p = 0; p < threads; ++p) {
+            producers.emplace_back([&ring, perProducer] {
+               for (uint64_t i = 0; i < perProducer; ++i) {
+                  ring->push(static_cast<uint32_t>(i));
+               }
+            });
+         }
+         uint64_t popped = 0;
+         uint32_t value = 0;
+         while (popped < perProducer * threads) {
+            popped += ring->tryPop(value) ? 1 : 0;
+         }
+         producers.clear();
+         return popped;
+      });
+   }
+   return allocationFree;
+}
+
+}   // namespace
+
+int main(const int argc, char** argv) {
+   const std::optional<BenchOptions> options = parseBenchOptions(std::span<char* const>(argv, static_cast<size_t>(argc)).subspan(1));
+   if (!options) {
+      Logger::error("usage: brights_bench [--out file] [--filter substring] [--min-ms n]");
+      return 1;
+   }
+
+   TileRegistry tileRegistry;
+   registerDefaultTiles(tileRegistry);
+   EntityRegistry entityRegistry;
+   registerDefaultEntities(entityRegistry);
+
+   BenchHarness bench(options->minDuration, options->filter);
+   benchGeneration(bench);
+   benchPresets(bench);
+   const bool climateWithinBound = benchClimateResolution(bench);
+   const bool classified = benchClassification(bench);
+   benchMeshing(bench, tileRegistry);
+   benchHeightField(bench, tileRegistry);
+   const bool roundTripped = benchPersistence(bench, tileRegistry, entityRegistry);
+   const bool allocationFree = benchThreading(bench);
+   return writeBenchResults(bench, *options, classified && climateWithinBound && roundTripped && allocationFree);
+}
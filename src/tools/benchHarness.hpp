@@ -0,0 +1,196 @@
+#pragma once
+
+#include "util/logger.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+inline const void* volatile keepAliveSink = nullptr;
+
+// keeps the optimizer from dropping a result nobody reads
+template<typename T>
+void keepAlive(const T& value) {
+   keepAliveSink = &value;
+   std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+// timing and json output for brights_bench. a case body gets an iteration count and returns how many items it
+// processed; the harness doubles the count until one run takes minDuration and reports that run per item
+class BenchHarness {
+public:
+   struct Param {
+      std::string key;
+      std::string value;   // written as is, so strings carry their own quotes
+   };
+
+   BenchHarness(const std::chrono::milliseconds minDuration, std::string filter): minDuration(minDuration), filter(std::move(filter)) {}
+
+   [[nodiscard]] bool selected(const std::string_view name) const { return filter.empty() || name.find(filter) != std::string_view::npos; }
+
+   // false when the filter skipped the case
+   template<typename Body>
+   bool run(std::string name, std::vector<Param> params, Body&& body) {
+      if (!selected(name)) {
+         return false;
+      }
+      keepAlive(body(1));   // warm caches and lazily built state
+
+      uint64_t iterations = 1;
+      for (;;) {
+         const auto start = std::chrono::steady_clock::now();
+         const uint64_t items = body(iterations);
+         const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+         if (elapsed >= minDuration || iterations >= maxIterations) {
+            results.push_back({std::move(name), std::move(params), items, elapsed.count(), {}});
+            return true;
+         }
+         iterations *= 2;
+      }
+   }
+
+   // attaches a figure to the case that ran last, e.g. bytes per encoded chunk. check run's result first
+   void addMetric(std::string key, const double value) {
+      if (!results.empty()) {
+         results.back().metrics.emplace_back(std::move(key), value);
+      }
+   }
+
+   // seconds per item of the case that ran last, for speed-ups between cases
+   [[nodiscard]] double lastSecondsPerItem() const {
+      if (results.empty() || results.back().items == 0) {
+         return 0.0;
+      }
+      return results.back().seconds / static_cast<double>(results.back().items);
+   }
+
+   [[nodiscard]] static std::string quote(const std::string_view text) {
+      std::string out = "\"";
+      for (const char c : text) {
+         if (c == '"' || c == '\\') {
+            out += '\\';
+         }
+         out += c;
+      }
+      return out + '"';
+   }
+
+   void writeJson(std::ostream& out, const std::vector<Param>& environment) const {
+      out << "{\n  \"environment\": {";
+      writeParams(out, environment);
+      out << "},\n  \"results\": [";
+      for (size_t i = 0; i < results.size(); ++i) {
+         const Result& result = results[i];
+         out << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << quote(result.name) << ", \"params\": {";
+         writeParams(out, result.params);
+         const double perItem = result.items == 0 ? 0.0 : result.seconds / static_cast<double>(result.items);
+         out << "}, \"items\": " << result.items << ", \"seconds\": " << result.seconds << ", \"nsPerItem\": " << perItem * 1e9
+             << ", \"itemsPerSecond\": " << (perItem == 0.0 ? 0.0 : 1.0 / perItem);
+         for (const auto& [key, value] : result.metrics) {
+            out << ", " << quote(key) << ": " << value;
+         }
+         out << "}";
+      }
+      out << "\n  ]\n}\n";
+   }
+
+private:
+   struct Result {
+      std::string name;
+      std::vector<Param> params;
+      uint64_t items;
+      double seconds;
+      std::vector<std::pair<std::string, double>> metrics;
+   };
+
+   static constexpr uint64_t maxIterations = uint64_t{1} << 30;
+
+   static void writeParams(std::ostream& out, const std::vector<Param>& params) {
+      for (size_t i = 0; i < params.size(); ++i) {
+         out << (i == 0 ? "" : ", ") << quote(params[i].key) << ": " << params[i].value;
+      }
+   }
+
+   std::chrono::milliseconds minDuration;
+   std::string filter;
+   std::vector<Result> results;
+};
+
+// the command line both bench tools take
+struct BenchOptions {
+   std::filesystem::path out;
+   std::string filter;
+   std::chrono::milliseconds minDuration{200};
+};
+
+inline std::optional<BenchOptions> parseBenchOptions(const std::span<char* const> args) {
+   BenchOptions options;
+   for (size_t i = 0; i < args.size(); ++i) {
+      const std::string_view arg = args[i];
+      if (i + 1 >= args.size()) {
+         return std::nullopt;
+      }
+      const std::string_view value = args[++i];
+      if (arg == "--out") {
+         options.out = value;
+      } else if (arg == "--filter") {
+         options.filter = value;
+      } else if (arg == "--min-ms") {
+         int ms = 0;
+         const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), ms);
+         if (error != std::errc{} || end != value.data() + value.size() || ms <= 0) {
+            return std::nullopt;
+         }
+         options.minDuration = std::chrono::milliseconds(ms);
+      } else {
+         return std::nullopt;
+      }
+   }
+   return options;
+}
+
+// json on stdout or into --out, with what the numbers depend on. the exit code is 1 when a check failed or the file
+// could not be written
+inline int writeBenchResults(const BenchHarness& bench, const BenchOptions& options, const bool checksPassed) {
+#if defined(BRIGHTS_WIDE_TILE_STORAGE)
+   constexpr std::string_view tileStorage = "wide";
+#else
+   constexpr std::string_view tileStorage = "compact";
+#endif
+#if defined(NDEBUG)
+   constexpr std::string_view buildType = "release";
+#else
+   constexpr std::string_view buildType = "debug";
+#endif
+   const std::vector<BenchHarness::Param> environment{
+      {"hardwareThreads", std::to_string(std::thread::hardware_concurrency())},
+      {"tileStorage", BenchHarness::quote(tileStorage)},
+      {"build", BenchHarness::quote(buildType)},
+      {"minDurationMs", std::to_string(options.minDuration.count())},
+   };
+
+   if (options.out.empty()) {
+      bench.writeJson(std::cout, environment);
+      return checksPassed ? 0 : 1;
+   }
+   std::ofstream file(options.out);
+   if (!file) {
+      Logger::error("could not write '{}'", options.out.string());
+      return 1;
+   }
+   bench.writeJson(file, environment);
+   return checksPassed ? 0 : 1;
+}
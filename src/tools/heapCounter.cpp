@@ -0,0 +1,44 @@
+#include "tools/heapCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+void* countedAllocate(const std::size_t size) noexcept {
+   allocations.fetch_add(1, std::memory_order_relaxed);
+   return std::malloc(size == 0 ? 1 : size);
+}
+
+}   // namespace
+
+uint64_t heapAllocations() { return allocations.load(std::memory_order_relaxed); }
+
+// every unaligned form is replaced, runtimes that bring their own array or nothrow forms would otherwise pair them
+// with these deletes. the aligned forms stay the runtime's, new and delete alike
+void* operator new(const std::size_t size) {
+   if (void* memory = countedAllocate(size)) {
+      return memory;
+   }
+   throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size) {
+   if (void* memory = countedAllocate(size)) {
+      return memory;
+   }
+   throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
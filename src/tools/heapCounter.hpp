@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// operator new calls of the whole process on any thread so far. linking heapCounter.cpp replaces the global
+// operator new, so only the bench does
+uint64_t heapAllocations();
@@ -0,0 +1,118 @@
+// streaming benchmark of a headless world area, results as json on stdout or into --out like brights_bench
+//
+//    brights_stream_bench [--out file] [--filter substring] [--min-ms n]
+//
+// the world area reaches webgpu through its render adapter, so this lives apart from brights_bench, which links the
+// world core only. no device is opened, the adapter keeps the maps on the cpu
+
+// the webgpu wrappers the render adapter calls, none of them runs without a device
+#define WEBGPU_CPP_IMPLEMENTATION
+#include "core/graphics/camera.hpp"
+#include "core/world/chunk.hpp"
+#include "core/world/contents/defaultEntities.hpp"
+#include "core/world/contents/defaultTiles.hpp"
+#include "core/world/generation/worldGenerator.hpp"
+#include "core/world/graphics/worldRenderAdapter.hpp"
+#include "core/world/streamingSettings.hpp"
+#include "core/world/worldArea.hpp"
+#include "tools/benchHarness.hpp"
+#include "util/logger.hpp"
+#include "util/threadpool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t seed = 1;
+
+// a headless world area panned at a steady speed in real time frames, counting the chunks of the visible disk that are
+// not meshed yet. prefetching should keep that near zero whatever the cache and generation level
+void benchStreaming(BenchHarness& bench, TileRegistry& tileRegistry, const EntityRegistry& entityRegistry) {
+   struct Config {
+      uint32_t prefetchMs;
+      size_t cacheBytes;
+      uint32_t lod;
+   };
+   constexpr std::array<Config, 4> configs{{{0, size_t{64} << 20, 0}, {1000, size_t{64} << 20, 0}, {1000, 0, 0}, {1000, 0, 2}}};
+   constexpr size_t threads = 4;
+   constexpr float tilesPerSecond = 300.0f;
+   constexpr std::chrono::microseconds frameTime{16667};
+   constexpr float dt = std::chrono::duration<float>(frameTime).count();
+   constexpr int settleFrames = 120;
+   constexpr int panFrames = 240;
+
+   for (const Config& config : configs) {
+      double missingSum = 0.0;
+      uint32_t missingPeak = 0;
+      uint64_t frames = 0;
+      const std::vector<BenchHarness::Param> params{
+         {"threads", std::to_string(threads)}, {"prefetchMs", std::to_string(config.prefetchMs)}, {"cacheMB", std::to_string(config.cacheBytes >> 20)}, {"lod", std::to_string(config.lod)}};
+      const bool ran = bench.run("worldArea/pan", params, [&](const uint64_t iterations) {
+         missingSum = 0.0;
+         missingPeak = 0;
+         frames = 0;
+         for (uint64_t i = 0; i < iterations; ++i) {
+            Threadpool pool(threads);
+            WorldGenerator generator(seed);
+            WorldRenderAdapter renderAdapter(nullptr, nullptr, nullptr, nullptr);
+            auto area = std::make_unique<WorldArea>(pool, tileRegistry, entityRegistry, generator, renderAdapter, 16, 0, std::filesystem::path{});
+            Camera camera;
+            camera.setOffset(glm::vec2(Chunk::SIZE * Chunk::COUNT / 2));
+            glm::ivec2 chunkMove{};
+            const StreamingBudget budget{std::chrono::microseconds(2000), config.cacheBytes, static_cast<float>(config.prefetchMs) / 1000.0f, config.lod};
+            for (int frame = 0; frame < settleFrames + panFrames; ++frame) {
+               const auto start = std::chrono::steady_clock::now();
+               if (frame >= settleFrames) {
+                  camera.setOffset(camera.getOffset() + glm::vec2(tilesPerSecond, tilesPerSecond * 0.5f) * dt);
+               }
+               area->update(camera, chunkMove, dt, {}, std::nullopt, budget);
+               renderAdapter.update(camera, chunkMove);
+               if (frame >= settleFrames) {
+                  const uint32_t missing = area->getStreamingStats().visibleMissing;
+                  missingSum += missing;
+                  missingPeak = std::max(missingPeak, missing);
+                  ++frames;
+               }
+               std::this_thread::sleep_until(start + frameTime);
+            }
+            // tasks still on the workers point into the area, the pool is drained first as in the game
+            pool.shutdown();
+            area.reset();
+         }
+         return frames;
+      });
+      if (ran) {
+         bench.addMetric("visibleMissingAvg", missingSum / static_cast<double>(frames));
+         bench.addMetric("visibleMissingPeak", missingPeak);
+      }
+   }
+}
+
+}   // namespace
+
+int main(const int argc, char** argv) {
+   const std::optional<BenchOptions> options = parseBenchOptions(std::span<char* const>(argv, static_cast<size_t>(argc)).subspan(1));
+   if (!options) {
+      Logger::error("usage: brights_stream_bench [--out file] [--filter substring] [--min-ms n]");
+      return 1;
+   }
+
+   TileRegistry tileRegistry;
+   registerDefaultTiles(tileRegistry);
+   EntityRegistry entityRegistry;
+   registerDefaultEntities(entityRegistry);
+
+   BenchHarness bench(options->minDuration, options->filter);
+   benchStreaming(bench, tileRegistry, entityRegistry);
+   return writeBenchResults(bench, *options, true);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "app/workerSettings.hpp"
+#include "core/world/streamingSettings.hpp"
+#include "core/world/streamingStats.hpp"
+
+#include <imgui.h>
+#include <vector>
+
+class StreamingPanel {
+public:
+   void draw(StreamingSettings& settings, WorkerSettings& workers, const size_t activeWorkers, const size_t workerCount, const std::vector<StreamingStats>& planets) {
+      if (!visible) {
+         return;
+      }
+
+      ImGui::SetNextWindowSize(ImVec2(300, 0), ImGuiCond_FirstUseEver);
+      if (!ImGui::Begin("Streaming", &visible)) {
+         ImGui::End();
+         return;
+      }
+
+      ImGui::SliderInt("Integration budget (us)", &settings.integrationBudgetUs, 100, 10000);
+      ImGui::SliderInt("Chunk cache (MB)", &settings.chunkCacheMB, 0, 512);
+      ImGui::SliderFloat("Prefetch (s)", &settings.prefetchSeconds, 0.0f, 4.0f, "%.1f");
+      ImGui::SliderFloat("Full detail from (px/tile)", &settings.fullDetailPixelsPerTile, 0.0f, 8.0f, "%.1f");
+      ImGui::Separator();
+
+      ImGui::Text("Workers         %zu / %zu active", activeWorkers, workerCount);
+      const int workerLimit = static_cast<int>(workerCount);
+      ImGui::SliderInt("Min workers", &workers.minWorkers, 1, workerLimit);
+      ImGui::SliderInt("Max workers (0 = all)", &workers.maxWorkers, 0, workerLimit);
+      ImGui::SliderFloat("Main thread budget (ms)", &workers.workBudgetMs, 2.0f, 33.0f, "%.1f");
+      ImGui::Checkbox("Pin workers to cores", &workers.pinWorkers);
+      ImGui::Separator();
+
+      for (size_t i = 0; i < planets.size(); ++i) {
+         const StreamingStats& stats = planets[i];
+         if (ImGui::TreeNodeEx(reinterpret_cast<void*>(i), ImGuiTreeNodeFlags_DefaultOpen, "Planet %zu", i)) {
+            ImGui::Text("Loaded chunks   %u", stats.loadedChunks);
+            ImGui::Text("Queued jobs     %u", stats.queuedJobs);
+            ImGui::Text("In-flight jobs  %u", stats.inFlightJobs);
+            ImGui::Text("Cancelled jobs  %llu", static_cast<unsigned long long>(stats.cancelledJobs));
+            ImGui::Text("Job slots       %u", stats.jobSlots);
+            ImGui::Text("Chunk pool      %u live, %u peak, %u slots", stats.liveChunks, stats.chunkHighWater, stats.pooledChunks);
+            ImGui::Text("Chunk memory    %.2f MB", static_cast<double>(stats.chunkPoolBytes) / (1024.0 * 1024.0));
+            const uint64_t lookups = stats.cacheHits + stats.cacheMisses;
+            const double hitRate = lookups == 0 ? 0.0 : 100.0 * static_cast<double>(stats.cacheHits) / static_cast<double>(lookups);
+            ImGui::Text("Chunk cache     %u chunks, %.2f MB, %.0f%% hits", stats.cachedChunks, static_cast<double>(stats.cacheBytes) / (1024.0 * 1024.0), hitRate);
+            ImGui::Text("Prefetched      %llu chunks", static_cast<unsigned long long>(stats.prefetchedChunks));
+            ImGui::Text("Generation LOD  %u, %u coarse chunks, %llu refined", stats.generationLod, stats.coarseChunks, static_cast<unsigned long long>(stats.refinedChunks));
+            ImGui::Text("Visible misses  %u chunks", stats.visibleMissing);
+            const uint64_t sparseSamples = stats.sparseSamplesEvaluated + stats.sparseSamplesSkipped;
+            const double skipRate = sparseSamples == 0 ? 0.0 : 100.0 * static_cast<double>(stats.sparseSamplesSkipped) / static_cast<double>(sparseSamples);
+            ImGui::Text("Ore/tree noise  %llu skipped, %.0f%%", static_cast<unsigned long long>(stats.sparseSamplesSkipped), skipRate);
+            ImGui::Text("Region store    %llu read, %llu written, %llu baked meshes", static_cast<unsigned long long>(stats.regionLoads),
+                        static_cast<unsigned long long>(stats.regionWrites), static_cast<unsigned long long>(stats.bakedMeshes));
+            ImGui::Text("Backlog         %u results", stats.integrationBacklog);
+            ImGui::Text("Integration     %.0f us", stats.lastIntegrationUs);
+            ImGui::Text("Worker hop      %.1f us", stats.workerHopUs);
+            ImGui::Text("Main hop        %.0f us", stats.mainHopUs);
+            if (stats.waitingForFirstVisible) {
+               ImGui::TextDisabled("First visible   waiting...");
+            } else {
+               ImGui::Text("First visible   %.2f ms", stats.timeToFirstVisibleMs);
+            }
+            ImGui::TreePop();
+         }
+      }
+
+      ImGui::End();
+   }
+
+   void toggle() { visible = !visible; }
+
+private:
+   bool visible = false;
+};
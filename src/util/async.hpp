@@ -0,0 +1,178 @@
+#pragma once
+#include "util/mpscRing.hpp"
+#include "util/threadpool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// detached coroutine: starts on the calling thread and frees its own frame when it returns.
+// a pipeline is written as one function that moves between threads with co_await hops
+class AsyncJob {
+public:
+   struct promise_type {
+      AsyncJob get_return_object() noexcept { return {}; }
+      std::suspend_never initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept { std::terminate(); }
+   };
+};
+
+// time from suspending on one side of a hop to resuming on the other, shared by every hop of one kind
+class HopStats {
+public:
+   void record(const std::chrono::steady_clock::duration latency) {
+      count.fetch_add(1, std::memory_order_relaxed);
+      totalNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()), std::memory_order_relaxed);
+   }
+
+   [[nodiscard]] uint64_t hops() const { return count.load(std::memory_order_relaxed); }
+
+   [[nodiscard]] float averageUs() const {
+      const uint64_t n = hops();
+      return n == 0 ? 0.0f : static_cast<float>(totalNs.load(std::memory_order_relaxed)) / static_cast<float>(n) / 1000.0f;
+   }
+
+private:
+   std::atomic<uint64_t> count{0};
+   std::atomic<uint64_t> totalNs{0};
+};
+
+// co_await resumeOn(pool) continues the coroutine as a pool task
+class PoolHop {
+public:
+   PoolHop(Threadpool& pool, HopStats* stats): pool(pool), stats(stats) {}
+
+   [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+   void await_suspend(const std::coroutine_handle<> handle) {
+      // the coroutine may finish on a worker before enqueue returns, nothing of *this is touched afterwards
+      start = std::chrono::steady_clock::now();
+      pool.enqueue([handle] { handle.resume(); });
+   }
+
+   void await_resume() const {
+      if (stats) {
+         stats->record(std::chrono::steady_clock::now() - start);
+      }
+   }
+
+private:
+   Threadpool& pool;
+   HopStats* stats;
+   std::chrono::steady_clock::time_point start;
+};
+
+inline PoolHop resumeOn(Threadpool& pool, HopStats* stats = nullptr) { return {pool, stats}; }
+
+// coroutines waiting to continue on the owning thread, which resumes them from its own loop.
+// callers bound what they have suspended here, see MpscRing::push
+template<size_t Capacity>
+class MainThreadQueue {
+public:
+   class Hop {
+   public:
+      Hop(MainThreadQueue& queue, HopStats* stats): queue(queue), stats(stats) {}
+
+      [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+      void await_suspend(const std::coroutine_handle<> handle) {
+         start = std::chrono::steady_clock::now();
+         queue.ring.push(std::coroutine_handle<>(handle));
+      }
+
+      void await_resume() const {
+         if (stats) {
+            stats->record(std::chrono::steady_clock::now() - start);
+         }
+      }
+
+   private:
+      MainThreadQueue& queue;
+      HopStats* stats;
+      std::chrono::steady_clock::time_point start;
+   };
+
+   [[nodiscard]] Hop hop(HopStats* stats = nullptr) { return {*this, stats}; }
+
+   // owner only
+   bool resumeOne() {
+      std::coroutine_handle<> handle;
+      if (!ring.tryPop(handle)) {
+         return false;
+      }
+      handle.resume();
+      return true;
+   }
+
+   [[nodiscard]] size_t size() const { return ring.size(); }
+
+   static constexpr size_t capacity() { return Capacity; }
+
+   MainThreadQueue() = default;
+   MainThreadQueue(const MainThreadQueue&) = delete;
+   MainThreadQueue(MainThreadQueue&&) = delete;
+   MainThreadQueue& operator =(const MainThreadQueue&) = delete;
+   MainThreadQueue& operator =(MainThreadQueue&&) = delete;
+
+   // whatever was never resumed dies with the queue
+   ~MainThreadQueue() {
+      std::coroutine_handle<> handle;
+      while (ring.tryPop(handle)) {
+         handle.destroy();
+      }
+   }
+
+private:
+   MpscRing<std::coroutine_handle<>, Capacity> ring;
+};
+
+// one-shot event. waiters resume inline on the thread that sets it, so they should hop away before heavy work
+class AsyncEvent {
+public:
+   void set() {
+      std::vector<std::coroutine_handle<>> ready;
+      {
+         const std::lock_guard<std::mutex> lock(mutex);
+         done.store(true, std::memory_order_release);
+         std::swap(ready, waiters);
+      }
+      for (const std::coroutine_handle<> handle : ready) {
+         handle.resume();
+      }
+   }
+
+   [[nodiscard]] bool isSet() const { return done.load(std::memory_order_acquire); }
+
+   auto operator co_await() noexcept {
+      struct Awaiter {
+         AsyncEvent& event;
+
+         [[nodiscard]] bool await_ready() const noexcept { return event.isSet(); }
+
+         bool await_suspend(const std::coroutine_handle<> handle) {
+            const std::lock_guard<std::mutex> lock(event.mutex);
+            if (event.done.load(std::memory_order_relaxed)) {
+               return false;
+            }
+            event.waiters.push_back(handle);
+            return true;
+         }
+
+         void await_resume() const noexcept {}
+      };
+      return Awaiter{*this};
+   }
+
+private:
+   std::mutex mutex;
+   std::atomic<bool> done{false};
+   std::vector<std::coroutine_handle<>> waiters;
+};
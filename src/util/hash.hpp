@@ -13,3 +13,18 @@ constexpr uint64_t fnv1a(std::string_view s) noexcept {
    }
    return h;
 }
+
+// splitmix64 finalizer, every input bit affects every output bit
+constexpr uint64_t mix64(uint64_t x) noexcept {
+   x ^= x >> 30;
+   x *= 0xbf58476d1ce4e5b9ull;
+   x ^= x >> 27;
+   x *= 0x94d049bb133111ebull;
+   x ^= x >> 31;
+   return x;
+}
+
+// stateless per-position random bits: the same seed and coordinates give the same value in any order
+constexpr uint64_t hashPosition(const uint64_t seed, const int32_t x, const int32_t y) noexcept {
+   return mix64(seed ^ mix64(static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y)));
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// move-only void() callable stored inline; anything that does not fit is a compile error, never a heap allocation
+template<size_t Capacity>
+class InplaceTask {
+public:
+   InplaceTask() = default;
+
+   template<typename F>
+      requires(!std::is_same_v<std::remove_cvref_t<F>, InplaceTask> && std::is_invocable_v<std::remove_cvref_t<F>&>)
+   // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+   InplaceTask(F&& f) {
+      using Fn = std::remove_cvref_t<F>;
+      static_assert(sizeof(Fn) <= Capacity, "task captures too much state for inline storage");
+      static_assert(alignof(Fn) <= alignof(std::max_align_t), "task is over-aligned for inline storage");
+      static_assert(std::is_nothrow_move_constructible_v<Fn>, "task must be nothrow movable");
+
+      ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+      ops = &opsFor<Fn>;
+   }
+
+   InplaceTask(InplaceTask&& other) noexcept { moveFrom(other); }
+
+   InplaceTask& operator =(InplaceTask&& other) noexcept {
+      if (this != &other) {
+         reset();
+         moveFrom(other);
+      }
+      return *this;
+   }
+
+   InplaceTask(const InplaceTask&) = delete;
+   InplaceTask& operator =(const InplaceTask&) = delete;
+
+   ~InplaceTask() { reset(); }
+
+   void operator ()() { ops->invoke(storage); }
+
+   explicit operator bool() const { return ops != nullptr; }
+
+   void reset() {
+      if (ops) {
+         ops->destroy(storage);
+         ops = nullptr;
+      }
+   }
+
+private:
+   struct Ops {
+      void (*invoke)(void*);
+      void (*relocate)(void* dst, void* src);
+      void (*destroy)(void*);
+   };
+
+   template<typename Fn>
+   static constexpr Ops opsFor{
+      .invoke = [](void* p) { (*static_cast<Fn*>(p))(); },
+      .relocate =
+         [](void* dst, void* src) {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+         },
+      .destroy = [](void* p) { static_cast<Fn*>(p)->~Fn(); }};
+
+   void moveFrom(InplaceTask& other) {
+      if (other.ops) {
+         other.ops->relocate(storage, other.storage);
+         ops = std::exchange(other.ops, nullptr);
+      }
+   }
+
+   alignas(std::max_align_t) std::byte storage[Capacity]{};
+   const Ops* ops = nullptr;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+// bounded multi-producer/single-consumer ring (Vyukov style per-slot sequence numbers).
+// slots are preallocated, values are moved in and out, so nothing is allocated per element
+template<typename T, size_t Capacity>
+class MpscRing {
+   static_assert(std::has_single_bit(Capacity), "capacity must be a power of two");
+
+public:
+   MpscRing() {
+      for (size_t i = 0; i < Capacity; ++i) {
+         slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+   }
+
+   // any thread; spins only while the ring is full, callers are expected to bound what they have in flight
+   void push(T&& value) {
+      const size_t pos = tail.fetch_add(1, std::memory_order_relaxed);
+      Slot& slot = slots[pos & mask];
+      while (slot.sequence.load(std::memory_order_acquire) != pos) {
+         std::this_thread::yield();
+      }
+      slot.value = std::move(value);
+      slot.sequence.store(pos + 1, std::memory_order_release);
+   }
+
+   // consumer only; never waits for a producer that has claimed a slot but not filled it yet
+   bool tryPop(T& out) {
+      Slot& slot = slots[head & mask];
+      if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+         return false;
+      }
+      out = std::move(slot.value);
+      slot.sequence.store(head + Capacity, std::memory_order_release);
+      ++head;
+      return true;
+   }
+
+   // consumer only; counts claimed slots, some of them may still be being filled
+   [[nodiscard]] size_t size() const { return tail.load(std::memory_order_relaxed) - head; }
+
+   static constexpr size_t capacity() { return Capacity; }
+
+private:
+   static constexpr size_t mask = Capacity - 1;
+
+   struct alignas(64) Slot {
+      std::atomic<size_t> sequence{0};
+      T value{};
+   };
+
+   std::array<Slot, Capacity> slots;
+   alignas(64) std::atomic<size_t> tail{0};
+   alignas(64) size_t head = 0;
+};
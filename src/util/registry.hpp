@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bitset>
 #include <cassert>
 #include <cstddef>
 #include <vector>
@@ -12,14 +13,22 @@ public:
    void add(const Id id, const Definition& definition) {
       assert(std::find(order.begin(), order.end(), id) == order.end());
       defs[static_cast<std::size_t>(id)] = definition;
+      registered.set(static_cast<std::size_t>(id));
       order.push_back(id);
    }
 
+   // for ids that come from outside, get() of an unregistered one returns a blank definition
+   [[nodiscard]] bool contains(const Id id) const {
+      const auto index = static_cast<std::size_t>(id);
+      return index < Capacity && registered.test(index);
+   }
+
    [[nodiscard]] const Definition& get(const Id id) const { return defs[static_cast<std::size_t>(id)]; }
 
    [[nodiscard]] const std::vector<Id>& list() const { return order; }
 
 private:
    std::array<Definition, Capacity> defs{};
+   std::bitset<Capacity> registered;
    std::vector<Id> order;
 };
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+// slab of recycled slots behind a lock-free free list. slots are addressed by index so the list head can carry
+// an ABA tag; segments are only ever added, never freed, so a steady state does not touch the heap.
+// objects are constructed once with their segment and handed out again as they were released
+template<typename T>
+class SlotArena {
+public:
+   SlotArena() = default;
+
+   T* acquire() {
+      if (T* item = tryPop()) {
+         return item;
+      }
+      return grow();
+   }
+
+   void release(T* item) {
+      static_assert(std::is_standard_layout_v<Slot>);
+      const Slot* s = reinterpret_cast<const Slot*>(item);
+      push(s->index, s->index);
+   }
+
+   [[nodiscard]] uint32_t capacity() const { return segmentCount.load(std::memory_order_relaxed) * segmentSize; }
+
+   // bytes per slot, the object plus its free list link
+   static constexpr size_t slotSize() { return sizeof(Slot); }
+
+   SlotArena(const SlotArena&) = delete;
+   SlotArena(SlotArena&&) = delete;
+   SlotArena& operator =(const SlotArena&) = delete;
+   SlotArena& operator =(SlotArena&&) = delete;
+   ~SlotArena() = default;
+
+private:
+   static constexpr uint32_t segmentSize = 256;
+   static constexpr uint32_t maxSegments = 1024;
+   static constexpr uint32_t nil = 0xFFFFFFFFu;
+
+   struct alignas(64) Slot {
+      T item;   // first member, release() casts back from it
+      std::atomic<uint32_t> nextFree{nil};
+      uint32_t index = 0;
+   };
+
+   using Segment = std::array<Slot, segmentSize>;
+
+   static uint64_t pack(const uint32_t tag, const uint32_t index) { return static_cast<uint64_t>(tag) << 32 | index; }
+   static uint32_t indexOf(const uint64_t head) { return static_cast<uint32_t>(head); }
+   static uint32_t tagOf(const uint64_t head) { return static_cast<uint32_t>(head >> 32); }
+
+   Slot& slot(const uint32_t index) { return (*segments[index / segmentSize].load(std::memory_order_acquire))[index % segmentSize]; }
+
+   T* tryPop() {
+      uint64_t head = freeHead.load(std::memory_order_acquire);
+      while (indexOf(head) != nil) {
+         const uint32_t index = indexOf(head);
+         const uint32_t next = slot(index).nextFree.load(std::memory_order_relaxed);
+         if (freeHead.compare_exchange_weak(head, pack(tagOf(head) + 1, next), std::memory_order_acquire, std::memory_order_acquire)) {
+            return &slot(index).item;
+         }
+      }
+      return nullptr;
+   }
+
+   // pushes the already linked run first..last
+   void push(const uint32_t first, const uint32_t last) {
+      uint64_t head = freeHead.load(std::memory_order_relaxed);
+      do {
+         slot(last).nextFree.store(indexOf(head), std::memory_order_relaxed);
+      } while (!freeHead.compare_exchange_weak(head, pack(tagOf(head) + 1, first), std::memory_order_release, std::memory_order_relaxed));
+   }
+
+   T* grow() {
+      const std::lock_guard<std::mutex> lock(growMutex);
+      // another thread may have grown or released while this one waited for the lock
+      if (T* item = tryPop()) {
+         return item;
+      }
+      const uint32_t segmentIndex = segmentCount.load(std::memory_order_relaxed);
+      if (segmentIndex == maxSegments) {
+         std::terminate();
+      }
+      ownedSegments[segmentIndex] = std::make_unique<Segment>();
+      Segment& segment = *ownedSegments[segmentIndex];
+      const uint32_t base = segmentIndex * segmentSize;
+      for (uint32_t i = 0; i < segmentSize; ++i) {
+         segment[i].index = base + i;
+         segment[i].nextFree.store(base + i + 1, std::memory_order_relaxed);
+      }
+      segments[segmentIndex].store(&segment, std::memory_order_release);
+      segmentCount.store(segmentIndex + 1, std::memory_order_relaxed);
+
+      // keep the first slot, hand the rest to the free list
+      push(base + 1, base + segmentSize - 1);
+      return &segment[0].item;
+   }
+
+   std::atomic<uint64_t> freeHead{pack(0, nil)};
+   std::array<std::atomic<Segment*>, maxSegments> segments{};
+   std::array<std::unique_ptr<Segment>, maxSegments> ownedSegments;
+   std::atomic<uint32_t> segmentCount{0};
+   std::mutex growMutex;
+};
@@ -1,54 +1,86 @@
 #pragma once
-#include <condition_variable>
-#include <functional>
+#include "platform/threadAffinity.hpp"
+#include "util/inplaceTask.hpp"
+#include "util/slotArena.hpp"
+#include "util/workStealingDeque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <thread>
 #include <vector>
 
+// work-stealing pool: every worker owns a lock-free deque, tasks enqueued from outside go through a shared
+// injection queue that workers drain in batches, so the mutex is touched once per batch instead of once per task.
+// tasks live in recycled arena slots with inline capture storage, so a warm pool never allocates on enqueue.
+// all threads are spawned up front, only the first activeWorkers() take tasks and the rest stay parked
 class Threadpool {
 public:
-   explicit Threadpool(const size_t threads) {
+   explicit Threadpool(const size_t threads): active(threads) {
       for (size_t i = 0; i < threads; ++i) {
-         workers.emplace_back([this] {
-            for (;;) {
-               std::function<void()> task;
-               {
-                  std::unique_lock<std::mutex> lock(this->queueMutex);
-                  this->condition.wait(lock, [this] { return this->stop || !this->tasks.empty(); });
-                  if (this->stop && this->tasks.empty()) {
-                     return;
-                  }
-                  task = std::move(this->tasks.front());
-                  this->tasks.pop();
-               }
-               task();
-            }
-         });
+         workers.push_back(std::make_unique<Worker>());
+      }
+      for (size_t i = 0; i < threads; ++i) {
+         workers[i]->thread = std::thread([this, i] { workerLoop(i); });
       }
    }
 
    template<class F>
    void enqueue(F&& f) {
-      {
-         const std::unique_lock<std::mutex> lock(queueMutex);
-         tasks.emplace(std::forward<F>(f));
+      Task* task = arena.acquire();
+      *task = Task(std::forward<F>(f));
+      if (currentPool == this) {
+         workers[currentWorker]->deque.push(task);
+      } else {
+         const std::lock_guard<std::mutex> lock(injectMutex);
+         injected.push_back(task);
+         injectedCount.fetch_add(1, std::memory_order_relaxed);
       }
-      condition.notify_one();
+      wakeOne();
    }
 
-   void shutdown() {
-      {
-         const std::unique_lock<std::mutex> lock(queueMutex);
-         stop = true;
+   // shrinking is lazy: a worker above the limit finishes its current task and hands its deque back first
+   void setActiveWorkers(const size_t count) {
+      const size_t next = std::clamp(count, size_t{1}, workers.size());
+      if (active.exchange(next, std::memory_order_seq_cst) == next) {
+         return;
       }
-      condition.notify_all();
-      for (std::thread& worker : workers) {
-         worker.join();
+      active.notify_all();
+      // sleepers above the new limit have to leave wakeEpoch, or they would swallow wakeOne() calls
+      wakeEpoch.fetch_add(1, std::memory_order_release);
+      wakeEpoch.notify_all();
+   }
+
+   // worker i goes to core i + 1, core 0 is left to the main thread
+   void pinWorkers(const bool pin) {
+      for (size_t i = 0; i < workers.size(); ++i) {
+         setThreadAffinity(workers[i]->thread, pin ? std::optional<unsigned>(static_cast<unsigned>(i + 1)) : std::nullopt);
+      }
+   }
+
+   void shutdown() {
+      stop.store(true, std::memory_order_seq_cst);
+      active.store(workers.size(), std::memory_order_seq_cst);
+      active.notify_all();
+      wakeEpoch.fetch_add(1, std::memory_order_release);
+      wakeEpoch.notify_all();
+      for (const std::unique_ptr<Worker>& worker : workers) {
+         if (worker->thread.joinable()) {
+            worker->thread.join();
+         }
       }
       workers.clear();
    }
 
+   [[nodiscard]] size_t size() const { return workers.size(); }
+   [[nodiscard]] size_t activeWorkers() const { return active.load(std::memory_order_relaxed); }
+
+   // stops growing once streaming reaches a steady state
+   [[nodiscard]] uint32_t jobSlots() const { return arena.capacity(); }
+
    ~Threadpool() { shutdown(); }
 
    Threadpool(const Threadpool&) = delete;
@@ -57,9 +89,161 @@ public:
    Threadpool& operator =(Threadpool&&) = delete;
 
 private:
-   std::vector<std::thread> workers;
-   std::queue<std::function<void()>> tasks;
-   std::mutex queueMutex;
-   std::condition_variable condition;
-   bool stop{false};
+   // fits a captured this plus a shared_ptr with room to spare. with the arena's link that is one cache line per task
+   using Task = InplaceTask<40>;
+   static_assert(SlotArena<Task>::slotSize() == 64);
+
+   struct Worker {
+      WorkStealingDeque<Task> deque;
+      std::thread thread;
+   };
+
+   static constexpr size_t maxInjectBatch = 32;
+
+   void workerLoop(const size_t index) {
+      currentPool = this;
+      currentWorker = index;
+
+      for (;;) {
+         if (index >= active.load(std::memory_order_acquire)) {
+            retire(*workers[index]);
+            if (!parkInactive(index)) {
+               return;
+            }
+            continue;
+         }
+
+         if (Task* task = findTask(index)) {
+            (*task)();
+            task->reset();
+            arena.release(task);
+            continue;
+         }
+
+         // park: announce the sleeper before the final check, enqueue publishes before reading sleepers
+         const uint32_t epoch = wakeEpoch.load(std::memory_order_acquire);
+         sleepers.fetch_add(1, std::memory_order_seq_cst);
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+         if (hasWork() || index >= active.load(std::memory_order_relaxed)) {
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+         }
+         if (stop.load(std::memory_order_seq_cst)) {
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            return;
+         }
+         wakeEpoch.wait(epoch, std::memory_order_acquire);
+         sleepers.fetch_sub(1, std::memory_order_relaxed);
+      }
+   }
+
+   // moves whatever is left in a deactivated worker's deque to the injection queue
+   void retire(Worker& self) {
+      size_t moved = 0;
+      {
+         const std::lock_guard<std::mutex> lock(injectMutex);
+         while (Task* task = self.deque.pop()) {
+            injected.push_back(task);
+            ++moved;
+         }
+         injectedCount.fetch_add(moved, std::memory_order_relaxed);
+      }
+      if (moved != 0) {
+         wakeOne();
+      }
+   }
+
+   // returns false when the pool is stopping
+   bool parkInactive(const size_t index) {
+      for (size_t limit = active.load(std::memory_order_acquire); index >= limit; limit = active.load(std::memory_order_acquire)) {
+         if (stop.load(std::memory_order_seq_cst)) {
+            return false;
+         }
+         active.wait(limit, std::memory_order_acquire);
+      }
+      return true;
+   }
+
+   Task* findTask(const size_t index) {
+      Worker& self = *workers[index];
+      if (Task* task = self.deque.pop()) {
+         return task;
+      }
+      if (Task* task = takeInjected(self)) {
+         return task;
+      }
+      for (size_t i = 1; i < workers.size(); ++i) {
+         if (Task* task = workers[(index + i) % workers.size()]->deque.steal()) {
+            return task;
+         }
+      }
+      return nullptr;
+   }
+
+   // moves a fair share of the injection queue into the local deque and returns one task to run right away
+   Task* takeInjected(Worker& self) {
+      if (injectedCount.load(std::memory_order_relaxed) == 0) {
+         return nullptr;
+      }
+      const std::lock_guard<std::mutex> lock(injectMutex);
+      const size_t available = injected.size() - injectedHead;
+      if (available == 0) {
+         return nullptr;
+      }
+      const size_t batch = std::clamp(available / workers.size(), size_t{1}, maxInjectBatch);
+      Task* first = injected[injectedHead];
+      for (size_t i = 1; i < batch; ++i) {
+         self.deque.push(injected[injectedHead + i]);
+      }
+      injectedHead += batch;
+      compactInjected();
+      injectedCount.fetch_sub(batch, std::memory_order_relaxed);
+      if (batch > 1) {
+         wakeOne();
+      }
+      return first;
+   }
+
+   // the injection queue is a vector consumed from injectedHead; it is reused in place so its capacity sticks
+   void compactInjected() {
+      if (injectedHead == injected.size()) {
+         injected.clear();
+         injectedHead = 0;
+      } else if (injectedHead > maxInjectBatch && injectedHead * 2 > injected.size()) {
+         injected.erase(injected.begin(), injected.begin() + static_cast<std::ptrdiff_t>(injectedHead));
+         injectedHead = 0;
+      }
+   }
+
+   [[nodiscard]] bool hasWork() const {
+      if (injectedCount.load(std::memory_order_relaxed) != 0) {
+         return true;
+      }
+      return std::ranges::any_of(workers, [](const std::unique_ptr<Worker>& worker) { return !worker->deque.empty(); });
+   }
+
+   void wakeOne() {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (sleepers.load(std::memory_order_relaxed) != 0) {
+         wakeEpoch.fetch_add(1, std::memory_order_release);
+         wakeEpoch.notify_one();
+      }
+   }
+
+   static inline thread_local const Threadpool* currentPool = nullptr;
+   static inline thread_local size_t currentWorker = 0;
+
+   std::vector<std::unique_ptr<Worker>> workers;
+   std::atomic<size_t> active;
+
+   SlotArena<Task> arena;
+
+   std::vector<Task*> injected;
+   size_t injectedHead = 0;
+   std::mutex injectMutex;
+   std::atomic<size_t> injectedCount{0};
+
+   std::atomic<uint32_t> wakeEpoch{0};
+   std::atomic<uint32_t> sleepers{0};
+   std::atomic<bool> stop{false};
 };
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models").
+// the owner pushes and pops at the bottom, any other thread steals from the top
+template<typename T>
+class WorkStealingDeque {
+public:
+   // capacity must stay a power of two, the ring index is masked
+   explicit WorkStealingDeque(const int64_t initialCapacity = 256) {
+      buffers.push_back(std::make_unique<Buffer>(initialCapacity));
+      buffer.store(buffers.back().get(), std::memory_order_relaxed);
+   }
+
+   // owner only
+   void push(T* item) {
+      const int64_t b = bottom.load(std::memory_order_relaxed);
+      const int64_t t = top.load(std::memory_order_acquire);
+      Buffer* buf = buffer.load(std::memory_order_relaxed);
+      if (b - t > buf->capacity - 1) {
+         buf = grow(buf, t, b);
+      }
+      buf->put(b, item);
+      std::atomic_thread_fence(std::memory_order_release);
+      bottom.store(b + 1, std::memory_order_relaxed);
+   }
+
+   // owner only
+   T* pop() {
+      const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+      Buffer* buf = buffer.load(std::memory_order_relaxed);
+      bottom.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t t = top.load(std::memory_order_relaxed);
+
+      if (t > b) {
+         bottom.store(b + 1, std::memory_order_relaxed);
+         return nullptr;
+      }
+
+      T* item = buf->get(b);
+      if (t == b) {
+         if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            item = nullptr;
+         }
+         bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return item;
+   }
+
+   // any thread
+   T* steal() {
+      int64_t t = top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const int64_t b = bottom.load(std::memory_order_acquire);
+
+      if (t >= b) {
+         return nullptr;
+      }
+
+      T* item = buffer.load(std::memory_order_acquire)->get(t);
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+         return nullptr;
+      }
+      return item;
+   }
+
+   [[nodiscard]] bool empty() const { return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed); }
+
+   WorkStealingDeque(const WorkStealingDeque&) = delete;
+   WorkStealingDeque(WorkStealingDeque&&) = delete;
+   WorkStealingDeque& operator =(const WorkStealingDeque&) = delete;
+   WorkStealingDeque& operator =(WorkStealingDeque&&) = delete;
+   ~WorkStealingDeque() = default;
+
+private:
+   struct Buffer {
+      int64_t capacity;
+      int64_t mask;
+      std::unique_ptr<std::atomic<T*>[]> slots;
+
+      explicit Buffer(const int64_t capacity): capacity(capacity), mask(capacity - 1), slots(std::make_unique<std::atomic<T*>[]>(static_cast<size_t>(capacity))) {}
+
+      void put(const int64_t i, T* item) { slots[i & mask].store(item, std::memory_order_relaxed); }
+
+      [[nodiscard]] T* get(const int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+   };
+
+   // retired buffers stay alive until the deque dies, a concurrent stealer may still read them
+   Buffer* grow(const Buffer* old, const int64_t t, const int64_t b) {
+      buffers.push_back(std::make_unique<Buffer>(old->capacity * 2));
+      Buffer* next = buffers.back().get();
+      for (int64_t i = t; i < b; ++i) {
+         next->put(i, old->get(i));
+      }
+      buffer.store(next, std::memory_order_release);
+      return next;
+   }
+
+   alignas(64) std::atomic<int64_t> top{0};
+   alignas(64) std::atomic<int64_t> bottom{0};
+   alignas(64) std::atomic<Buffer*> buffer{nullptr};
+   std::vector<std::unique_ptr<Buffer>> buffers;
+};